@@ -0,0 +1,67 @@
+#include "benchmark.hpp"
+#include <numeric>
+#include <fmt/format.h>
+
+namespace qtor::bench
+{
+	bool runner::enabled(std::string_view name) const
+	{
+		return m_options.filter.empty() or name.find(m_options.filter) != name.npos;
+	}
+
+	void runner::add_result(std::string name, std::size_t size, std::vector<clock_type::duration> & timings)
+	{
+		using std::chrono::duration_cast;
+		using std::chrono::nanoseconds;
+
+		std::sort(timings.begin(), timings.end());
+		auto total = std::accumulate(timings.begin(), timings.end(), clock_type::duration());
+
+		benchmark_result result;
+		result.name = std::move(name);
+		result.size = size;
+		result.iterations = static_cast<unsigned>(timings.size());
+		result.min = duration_cast<nanoseconds>(timings.front());
+		result.median = duration_cast<nanoseconds>(timings[timings.size() / 2]);
+		result.mean = duration_cast<nanoseconds>(total / timings.size());
+
+		m_results.push_back(std::move(result));
+	}
+
+	auto runner::to_json() const -> std::string
+	{
+		std::string out = "{\n\t\"benchmarks\": [";
+
+		bool first = true;
+		for (auto & result : m_results)
+		{
+			if (not first) out += ',';
+			first = false;
+
+			// benchmark names are plain identifiers, no escaping is needed
+			fmt::format_to(std::back_inserter(out),
+				"\n\t\t{{\"name\": \"{}\", \"size\": {}, \"iterations\": {}, \"min_ns\": {}, \"median_ns\": {}, \"mean_ns\": {}}}",
+				result.name, result.size, result.iterations,
+				result.min.count(), result.median.count(), result.mean.count());
+		}
+
+		out += "\n\t]\n}\n";
+		return out;
+	}
+
+	auto runner::to_table() const -> std::string
+	{
+		std::string out;
+		fmt::format_to(std::back_inserter(out), "{:<48} {:>8} {:>6} {:>14} {:>14} {:>14}\n",
+			"name", "size", "iters", "min, us", "median, us", "mean, us");
+
+		for (auto & result : m_results)
+		{
+			fmt::format_to(std::back_inserter(out), "{:<48} {:>8} {:>6} {:>14.1f} {:>14.1f} {:>14.1f}\n",
+				result.name, result.size, result.iterations,
+				result.min.count() / 1000.0, result.median.count() / 1000.0, result.mean.count() / 1000.0);
+		}
+
+		return out;
+	}
+}
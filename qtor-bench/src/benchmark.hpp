@@ -0,0 +1,107 @@
+#pragma once
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+namespace qtor::bench
+{
+	using clock_type = std::chrono::steady_clock;
+
+	struct benchmark_result
+	{
+		std::string name;
+		std::size_t size;       // number of items benchmark operates on
+		unsigned iterations;
+
+		std::chrono::nanoseconds min;
+		std::chrono::nanoseconds median;
+		std::chrono::nanoseconds mean;
+	};
+
+	struct runner_options
+	{
+		/// each benchmark runs at least min_time and min_iterations, but no more than max_iterations
+		std::chrono::milliseconds min_time = std::chrono::milliseconds(500);
+		unsigned min_iterations = 5;
+		unsigned max_iterations = 1000;
+		/// only benchmarks which name contains filter are run
+		std::string filter;
+	};
+
+	/// Runs benchmarks and collects timings.
+	/// Benchmark body returns some value derived from computed result, it's accumulated into volatile sink,
+	/// so compiler can't throw computation away.
+	class runner
+	{
+	private:
+		runner_options m_options;
+		std::vector<benchmark_result> m_results;
+		volatile std::size_t m_sink = 0;
+
+	private:
+		void add_result(std::string name, std::size_t size, std::vector<clock_type::duration> & timings);
+
+	public:
+		bool enabled(std::string_view name) const;
+
+		/// setup is invoked before each iteration and is not measured, its result is passed to body by reference
+		template <class Setup, class Body>
+		void run(std::string name, std::size_t size, Setup setup, Body body);
+
+		template <class Body>
+		void run(std::string name, std::size_t size, Body body);
+
+	public:
+		auto results() const noexcept -> const std::vector<benchmark_result> & { return m_results; }
+		/// results as json document: {"benchmarks": [{"name", "size", "iterations", "min_ns", "median_ns", "mean_ns"}, ...]}
+		auto to_json() const -> std::string;
+		/// results as human readable table
+		auto to_table() const -> std::string;
+
+	public:
+		runner(runner_options options) : m_options(std::move(options)) {}
+	};
+
+
+	template <class Setup, class Body>
+	void runner::run(std::string name, std::size_t size, Setup setup, Body body)
+	{
+		if (not enabled(name)) return;
+
+		std::vector<clock_type::duration> timings;
+		clock_type::duration total = {};
+
+		// warm up, not measured
+		{
+			auto state = setup();
+			m_sink = m_sink + static_cast<std::size_t>(body(state));
+		}
+
+		while (timings.size() < m_options.max_iterations and
+		      (timings.size() < m_options.min_iterations or total < m_options.min_time))
+		{
+			auto state = setup();
+
+			auto start = clock_type::now();
+			m_sink = m_sink + static_cast<std::size_t>(body(state));
+			auto elapsed = clock_type::now() - start;
+
+			timings.push_back(elapsed);
+			total += elapsed;
+		}
+
+		add_result(std::move(name), size, timings);
+	}
+
+	template <class Body>
+	void runner::run(std::string name, std::size_t size, Body body)
+	{
+		struct empty_state {};
+		run(std::move(name), size,
+			[] { return empty_state(); },
+			[&body](empty_state &) { return body(); });
+	}
+}
@@ -0,0 +1,343 @@
+#include <memory>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QCommandLineParser>
+
+#include <qtor/torrent.hpp>
+#include <qtor/torrent_file.hpp>
+#include <qtor/torrent_store.hpp>
+#include <qtor/transfer_history.hpp>
+#include <qtor/torrent_snapshot.hpp>
+#include <qtor/sqlite.hpp>
+#include <qtor/formatter.hpp>
+#include <qtor/TorrentsModel.hpp>
+#include <qtor/FileTreeModel.hqt>
+
+#include <qtor/transmission/requests.hpp>
+#include <qtor/transmission/replay_data_source.hpp>
+
+#include <mock_daemon.hpp>
+#include "benchmark.hpp"
+
+namespace qtor::bench
+{
+	// same columns TorrentsModel shows
+	static const sparse_container::index_type formatted_columns[] =
+	{
+		torrent::Name, torrent::ErrorString,
+		torrent::CurrentSize, torrent::RequestedSize, torrent::TotalSize,
+		torrent::DownloadSpeed, torrent::UploadSpeed,
+		torrent::Eta, torrent::EtaIdle,
+		torrent::ConnectedPeers, torrent::UploadingPeers, torrent::DownloadingPeers, torrent::DownloadingWebseeds,
+		torrent::DateAdded, torrent::DateCreated, torrent::DateStarted, torrent::DateDone,
+	};
+
+	/// torrent-get response for count synthetic torrents, same as real daemon would return for default fields
+	static auto make_torrents_json(std::size_t count) -> std::string
+	{
+		mock::mock_options options;
+		options.torrents = static_cast<unsigned>(count);
+		options.seed = 42;
+
+		mock::mock_daemon daemon(options);
+		return daemon.handle(transmission::make_torrent_get_command(torrent_id_list(), transmission::request_default_fields));
+	}
+
+	/// flat file list of one torrent, files are spread over 64 x 16 directories
+	static auto make_file_list(std::size_t count) -> torrent_file_list
+	{
+		torrent_file_list files;
+		files.reserve(count);
+
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			torrent_file file;
+			file.filename = QStringLiteral("dir%1/sub%2/file%3.bin").arg(i % 64).arg(i / 64 % 16).arg(i);
+			file.total_size = (i % 100 + 1) * 1024 * 1024;
+			file.have_size = i % 2 ? file.total_size : 0;
+			file.index = static_cast<int_type>(i);
+			file.priority = 0;
+			file.wanted = true;
+
+			files.push_back(std::move(file));
+		}
+
+		return files;
+	}
+
+	/// simulates next daemon snapshot: every torrent has new download speed
+	static void touch_torrents(torrent_list & torrents, unsigned generation)
+	{
+		for (auto & torr : torrents)
+			torr.download_speed(generation * 1024);
+	}
+
+	static void run_torrent_benchmarks(runner & bench, std::size_t size)
+	{
+		auto json = make_torrents_json(size);
+
+		auto torrents = transmission::parse_torrent_list(json);
+
+		bench.run("parse_torrent_list", size, [&json]
+		{
+			return transmission::parse_torrent_list(json).size();
+		});
+
+		// replay source without recording never emits anything,
+		// it only satisfies view_manager subscription of torrent_store
+		auto source = std::make_shared<transmission::replay_data_source>();
+		unsigned generation = 0;
+
+		auto make_snapshot = [&torrents, &generation]
+		{
+			auto snapshot = torrents;
+			touch_torrents(snapshot, ++generation);
+			return snapshot;
+		};
+
+		{
+			auto store = std::make_shared<torrent_store>(source);
+			store->assign_records(torrents);
+
+			bench.run("torrent_store::upsert_records", size, make_snapshot, [&store](torrent_list & snapshot)
+			{
+				store->upsert_records(std::move(snapshot));
+				return store->size();
+			});
+		}
+
+		{
+			auto store = std::make_shared<torrent_store>(source);
+			store->assign_records(torrents);
+			TorrentsModel model(store);
+
+			bench.run("torrent_store::upsert_records+TorrentsModel", size, make_snapshot, [&store, &model](torrent_list & snapshot)
+			{
+				store->upsert_records(std::move(snapshot));
+				return model.rowCount();
+			});
+
+			bool ascending = false;
+			auto sort_by = [&model, &ascending](int column)
+			{
+				ascending = not ascending;
+				model.sort(column, ascending ? Qt::AscendingOrder : Qt::DescendingOrder);
+				return model.rowCount();
+			};
+
+			int name_column = model.MetaToViewIndex(torrent::Name);
+			int speed_column = model.MetaToViewIndex(torrent::DownloadSpeed);
+			bench.run("TorrentsModel::sort(name)", size, std::bind(sort_by, name_column));
+			bench.run("TorrentsModel::sort(download_speed)", size, std::bind(sort_by, speed_column));
+
+			// alternate expressions, so every iteration does full refilter
+			const QString exprs[] = {QStringLiteral("Linux"), QStringLiteral("Archive")};
+			unsigned n = 0;
+
+			bench.run("TorrentsModel::filter", size, [&model, &exprs, &n]
+			{
+				model.SetFilter(exprs[n++ % 2]);
+				return model.rowCount();
+			});
+		}
+
+		{
+			auto store = std::make_shared<torrent_store>(source);
+			store->assign_records(torrents);
+			transfer_history history(store);
+
+			// each iteration is one second later, so every one pushes sample of all torrents
+			auto now = transfer_history::clock_type::now();
+			bench.run("transfer_history::sample", size, [&history, &now]
+			{
+				now += std::chrono::seconds(1);
+				history.sample(now);
+				return history.tracked_torrents();
+			});
+		}
+
+		{
+			// torrent ids are integers, compare with keying same lookup by their former string form
+			std::unordered_map<torrent_id_type, const torrent *> by_id;
+			QHash<QString, const torrent *> by_string;
+			torrent_id_list ids;
+			QStringList string_ids;
+
+			for (auto & torr : torrents)
+			{
+				auto id = torr.id();
+				ids.push_back(id);
+				string_ids.push_back(QString::number(id));
+				by_id.emplace(id, &torr);
+				by_string.insert(string_ids.back(), &torr);
+			}
+
+			bench.run("id_lookup(int64)", size, [&by_id, &ids]
+			{
+				std::size_t found = 0;
+				for (auto id : ids) found += by_id.count(id);
+				return found;
+			});
+
+			bench.run("id_lookup(QString)", size, [&by_string, &string_ids]
+			{
+				std::size_t found = 0;
+				for (auto & id : string_ids) found += by_string.contains(id);
+				return found;
+			});
+		}
+
+		{
+			sparse_container_filter filter;
+			filter.set_expr(QStringLiteral("linux"), {torrent::Name});
+
+			bench.run("sparse_container_filter::matches", size, [&torrents, &filter]
+			{
+				return std::count_if(torrents.begin(), torrents.end(), std::cref(filter));
+			});
+		}
+
+		{
+			formatter fmt;
+			auto & meta = default_torrent_meta();
+
+			bench.run("formatter::format_item", size, [&torrents, &fmt, &meta]
+			{
+				std::size_t length = 0;
+				for (auto & torr : torrents)
+					for (auto key : formatted_columns)
+						length += fmt.format_item(torr.get_item(key), meta.item_type(key)).size();
+
+				return length;
+			});
+		}
+	}
+
+	static void run_snapshot_benchmarks(runner & bench, std::size_t size)
+	{
+		auto torrents = transmission::parse_torrent_list(make_torrents_json(size));
+
+		QTemporaryDir dir;
+		auto snapshot_path = dir.filePath(QStringLiteral("torrents.snapshot"));
+		auto sqlite_path = dir.filePath(QStringLiteral("torrents.db")).toStdString();
+
+		bench.run("write_torrent_snapshot", size, [&torrents, &snapshot_path]
+		{
+			write_torrent_snapshot(snapshot_path, torrents);
+			return torrents.size();
+		});
+
+		bench.run("torrent_snapshot::to_torrent_list", size, [&snapshot_path]
+		{
+			return torrent_snapshot(snapshot_path).to_torrent_list().size();
+		});
+
+		// zero copy access, no torrent objects are created
+		bench.run("torrent_snapshot::get(total_size)", size, [&snapshot_path]
+		{
+			torrent_snapshot snapshot(snapshot_path);
+			size_type total = 0;
+			for (std::size_t row = 0; row < snapshot.size(); ++row)
+				total += snapshot.get<size_type>(row, torrent::TotalSize).value_or(0);
+
+			return total;
+		});
+
+		{
+			sqlite3yaw::session ses(sqlite_path);
+			sqlite::create_torrents_table(ses);
+			sqlite::save_torrents(ses, torrents);
+
+			bench.run("sqlite::load_torrents", size, [&ses]
+			{
+				return sqlite::load_torrents(ses).size();
+			});
+		}
+	}
+
+	static void run_file_benchmarks(runner & bench, std::size_t size)
+	{
+		auto files = make_file_list(size);
+		auto updated = files;
+		for (auto & file : updated)
+			file.have_size = file.total_size;
+
+		bench.run("FileTreeModel::assign", size,
+			[] { return std::make_unique<FileTreeModel>(); },
+			[&files](std::unique_ptr<FileTreeModel> & model)
+			{
+				model->assign(files);
+				return model->rowCount();
+			});
+
+		bench.run("FileTreeModel::upsert", size,
+			[&files] { auto model = std::make_unique<FileTreeModel>(); model->assign(files); return model; },
+			[&updated](std::unique_ptr<FileTreeModel> & model)
+			{
+				model->upsert(updated);
+				return model->rowCount();
+			});
+	}
+}
+
+int main(int argc, char * argv[])
+{
+	using namespace qtor::bench;
+	QCoreApplication qapp {argc, argv};
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("qtor microbenchmarks over synthetic data, results are written as json");
+	parser.addHelpOption();
+
+	QCommandLineOption sizesOption("sizes", "comma separated torrent/file counts, default 1000,10000,100000", "sizes", "1000,10000,100000");
+	QCommandLineOption filterOption("filter", "run only benchmarks which name contains <filter>", "filter");
+	QCommandLineOption outputOption("output", "write json results to <file> instead of stdout", "file");
+	QCommandLineOption minTimeOption("min-time", "minimal time each benchmark runs, milliseconds", "ms", "500");
+	parser.addOptions({sizesOption, filterOption, outputOption, minTimeOption});
+	parser.process(qapp);
+
+	runner_options options;
+	options.filter = parser.value(filterOption).toStdString();
+	options.min_time = std::chrono::milliseconds(parser.value(minTimeOption).toUInt());
+
+	std::vector<std::size_t> sizes;
+	for (auto & str : parser.value(sizesOption).split(',', QString::SkipEmptyParts))
+		sizes.push_back(str.trimmed().toULongLong());
+
+	runner bench(options);
+	for (auto size : sizes)
+	{
+		run_torrent_benchmarks(bench, size);
+		run_snapshot_benchmarks(bench, size);
+		run_file_benchmarks(bench, size);
+	}
+
+	std::cerr << bench.to_table();
+
+	if (not parser.isSet(outputOption))
+		std::cout << bench.to_json();
+	else
+	{
+		std::ofstream output(parser.value(outputOption).toStdString());
+		output << bench.to_json();
+
+		if (not output)
+		{
+			std::cerr << "failed to write " << parser.value(outputOption).toStdString() << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
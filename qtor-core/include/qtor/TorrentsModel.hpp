@@ -31,11 +31,18 @@ namespace qtor
 		using view_type::m_store;   // vector of pointers
 		using view_type::m_sort_pred;
 		using view_type::m_filter_pred;
+		using typename view_type::signal_range_type;
 
 	protected:
 		virtual void SortBy(int column, Qt::SortOrder order) override;
 		virtual void FilterBy(QString expr) override;
 
+		/// if store update changed neither rows set, nor sort key, nor filtered fields - rows stay in place,
+		/// only dataChanged for changed rows is emitted. Otherwise view is resorted/refiltered as usual
+		void update_data(const signal_range_type & sorted_erased, const signal_range_type & updated, const signal_range_type & inserted) override;
+		/// emits dataChanged for whole rows of actually changed torrents
+		void EmitChangedCells(const signal_range_type & updated);
+
 	public:
 		//virtual Qt::ItemFlags flags(const QModelIndex & index) const override;
 		virtual QVariant GetEntity(const QModelIndex & index) const override;
@@ -13,6 +13,7 @@
 
 #include <qtor/torrent.hpp>
 #include <qtor/torrent_file.hpp>
+#include <qtor/torrent_detail.hpp>
 
 namespace qtor
 {
@@ -21,6 +22,9 @@ namespace qtor
 	public:
 		using torrent_handler = std::function<void (torrent_list & list)>;
 		using session_stat_handler = std::function<void (session_stat & stats)>;
+		using torrent_detail_handler = std::function<void (torrent_detail & detail)>;
+		using torrent_peer_handler = std::function<void (torrent_peer_diff & diff)>;
+		using torrent_file_handler = std::function<void (torrent_file_update & update)>;
 
 	public:
 		virtual auto subscribe_session_stats(session_stat_handler handler) -> ext::net::subscription_handle = 0;
@@ -51,7 +55,23 @@ namespace qtor
 		virtual ext::future<torrent_peer_list> get_torrent_peers(torrent_id_type id) = 0;
 
 		virtual ext::future<tracker_list> get_trackers(torrent_id_type) { return ext::make_ready_future(tracker_list()); };
-		
+
+		/// batched variants, request details of many torrents at once
+		virtual ext::future<torrent_file_map> get_torrent_files(torrent_id_list ids) = 0;
+		virtual ext::future<tracker_map> get_trackers(torrent_id_list ids) { return ext::make_ready_future(tracker_map()); }
+
+		/// files, trackers and peers of a torrent retrieved at once
+		virtual ext::future<torrent_detail> get_torrent_detail(torrent_id_type id) = 0;
+		virtual auto subscribe_torrent_detail(torrent_id_type id, torrent_detail_handler handler) -> ext::net::subscription_handle = 0;
+
+		/// peers of a torrent, handler receives only added, removed and changed peers since previous invocation.
+		/// First invocation reports all peers as added.
+		virtual auto subscribe_torrent_peers(torrent_id_type id, torrent_peer_handler handler) -> ext::net::subscription_handle = 0;
+
+		/// files of a torrent, first invocation receives full file list,
+		/// following ones - only stats(have size, wanted, priority) of every file, while file count stays the same.
+		virtual auto subscribe_torrent_files(torrent_id_type id, torrent_file_handler handler) -> ext::net::subscription_handle = 0;
+
 	public:
 		virtual void set_address(std::string addr) = 0;
 		virtual void set_timeout(std::chrono::steady_clock::duration timeout) = 0;
@@ -61,6 +81,8 @@ namespace qtor
 
 	public:
 		virtual std::string last_errormsg() const = 0;
+		/// round trip time of last completed request, zero if unknown or not applicable
+		virtual auto last_latency() const -> std::chrono::steady_clock::duration { return {}; }
 
 	public:
 		virtual ~abstract_data_source() = default;
@@ -0,0 +1,179 @@
+#pragma once
+#include <map>
+#include <mutex>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <variant>
+#include <utility>
+#include <cstdint>
+#include <string_view>
+
+/// Always-on aggregated runtime metrics.
+/// Metric values are plain atomics, recording never locks.
+/// Metrics are registered in a registry once, callers keep references to them.
+/// Registry can be dumped as Prometheus text exposition format.
+
+namespace qtor::metrics
+{
+	class counter
+	{
+	private:
+		std::atomic<std::uint64_t> m_value = 0;
+
+	public:
+		void add(std::uint64_t n = 1) noexcept { m_value.fetch_add(n, std::memory_order_relaxed); }
+		auto value() const noexcept -> std::uint64_t { return m_value.load(std::memory_order_relaxed); }
+	};
+
+	class gauge
+	{
+	private:
+		std::atomic<std::int64_t> m_value = 0;
+		std::atomic<std::int64_t> m_max = 0;
+
+	public:
+		void add(std::int64_t delta) noexcept;
+		void set(std::int64_t value) noexcept;
+
+		auto value() const noexcept -> std::int64_t { return m_value.load(std::memory_order_relaxed); }
+		/// maximum value ever observed
+		auto max() const noexcept -> std::int64_t { return m_max.load(std::memory_order_relaxed); }
+	};
+
+	/// HDR-style log-linear histogram of non negative integer values.
+	/// Every power of two range is split into 8 linear sub buckets, so relative error is at most 12.5%.
+	/// Values below 8 are recorded exactly.
+	class histogram
+	{
+	public:
+		static constexpr unsigned sub_bucket_bits = 3;
+		static constexpr unsigned sub_bucket_count = 1 << sub_bucket_bits;
+		static constexpr unsigned bucket_count = (64 - sub_bucket_bits + 1) * sub_bucket_count;
+
+	private:
+		std::array<std::atomic<std::uint64_t>, bucket_count> m_buckets = {};
+		std::atomic<std::uint64_t> m_count = 0;
+		std::atomic<std::uint64_t> m_sum = 0;
+		std::atomic<std::uint64_t> m_max = 0;
+
+	public:
+		static auto bucket_index(std::uint64_t value) noexcept -> unsigned;
+		/// inclusive range of values recorded into bucket
+		static auto bucket_lower(unsigned idx) noexcept -> std::uint64_t;
+		static auto bucket_upper(unsigned idx) noexcept -> std::uint64_t;
+
+	public:
+		void record(std::uint64_t value) noexcept;
+
+		auto count() const noexcept -> std::uint64_t { return m_count.load(std::memory_order_relaxed); }
+		auto sum() const noexcept -> std::uint64_t { return m_sum.load(std::memory_order_relaxed); }
+		auto max() const noexcept -> std::uint64_t { return m_max.load(std::memory_order_relaxed); }
+		auto bucket(unsigned idx) const noexcept -> std::uint64_t { return m_buckets[idx].load(std::memory_order_relaxed); }
+
+		double mean() const noexcept;
+		/// approximate value at quantile q in [0, 1], upper bound of bucket containing it
+		auto quantile(double q) const noexcept -> std::uint64_t;
+	};
+
+	/// records elapsed time in microseconds into histogram on destruction
+	class scoped_timer
+	{
+	private:
+		histogram & m_histogram;
+		std::int64_t m_start;
+
+	public:
+		scoped_timer(histogram & hist) noexcept;
+		~scoped_timer() noexcept;
+
+		scoped_timer(const scoped_timer &) = delete;
+		scoped_timer & operator =(const scoped_timer &) = delete;
+	};
+
+	/// Named metrics storage. Metric is identified by name and labels, labels are in Prometheus syntax without braces:
+	/// method="torrent-get". Getting already registered metric returns same object.
+	class registry
+	{
+	public:
+		using metric_ptr = std::variant<std::unique_ptr<counter>, std::unique_ptr<gauge>, std::unique_ptr<histogram>>;
+
+		struct entry
+		{
+			std::string help;
+			metric_ptr metric;
+		};
+
+		/// (name, labels) -> entry, sorted by name, so same name metrics form a Prometheus family
+		using entry_map = std::map<std::pair<std::string, std::string>, entry>;
+
+	private:
+		mutable std::mutex m_mutex;
+		entry_map m_entries;
+
+	private:
+		template <class Metric>
+		Metric & get(std::string_view name, std::string_view labels, std::string_view help);
+
+	public:
+		counter & get_counter(std::string_view name, std::string_view help, std::string_view labels = {});
+		gauge & get_gauge(std::string_view name, std::string_view help, std::string_view labels = {});
+		histogram & get_histogram(std::string_view name, std::string_view help, std::string_view labels = {});
+
+		/// invokes visitor(name, labels, const entry &) for every metric under registry lock
+		template <class Visitor>
+		void for_each(Visitor && visitor) const;
+
+		/// Prometheus text exposition format
+		std::string to_prometheus() const;
+		/// writes to_prometheus to file, returns false on failure
+		bool write_prometheus(const std::string & path) const;
+
+	public:
+		/// process wide default registry
+		static registry & instance();
+	};
+
+	/// metrics of one rpc method
+	struct rpc_metrics
+	{
+		counter & requests;
+		counter & request_bytes;
+		counter & response_bytes;
+		histogram & latency_us;
+	};
+
+	/// metrics of data pipeline stages
+	struct pipeline_metrics
+	{
+		histogram & parse_ns_per_torrent;   // parse_torrent_list time divided by number of torrents
+		histogram & upsert_batch_size;      // records per torrent_store upsert/assign
+		counter   & upsert_unchanged;       // upserted records skipped because no field changed
+		histogram & sort_us;                // TorrentsModel resort time, count is number of resorts
+		histogram & filter_us;              // TorrentsModel refilter time
+		gauge     & gui_queue_depth;        // snapshots posted to gui executor, not yet processed
+		counter   & snapshots_coalesced;    // snapshots merged into already pending emission
+		counter   & snapshots_dropped;      // snapshots discarded because subscription was no longer opened
+		gauge     & startup_first_paint_ms; // from start to first main window paint, milliseconds
+		gauge     & startup_first_live_ms;  // from start to first live torrents snapshot applied to store, milliseconds
+		gauge     & startup_snapshot_size;  // torrents loaded from warm start snapshot
+		gauge     & string_pool_size;       // strings in all string pools
+		gauge     & string_pool_shared_bytes;// bytes saved by pooled strings sharing buffers, as of last collect
+	};
+
+	/// metrics of rpc method in default registry, thread safe, locks registry - cache the result
+	rpc_metrics & rpc(std::string_view method);
+	/// pipeline metrics in default registry
+	pipeline_metrics & pipeline();
+
+
+	template <class Visitor>
+	void registry::for_each(Visitor && visitor) const
+	{
+		std::lock_guard lk(m_mutex);
+		for (auto & [key, entry] : m_entries)
+			visitor(key.first, key.second, entry);
+	}
+}
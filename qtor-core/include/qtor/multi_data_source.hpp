@@ -0,0 +1,122 @@
+#pragma once
+#include <ext/net/abstract_connection_controller.hpp>
+#include <ext/net/abstract_subscription_controller.hpp>
+#include <qtor/abstract_data_source.hpp>
+
+namespace qtor
+{
+	/// Aggregates several data sources(daemons) into one.
+	/// Each child polls it's daemon independently, merged subscriptions coalesce latest data of all children,
+	/// so slow or dead daemon does not stall others - it's last data is used until new one arrives.
+	///
+	/// Torrent ids are namespaced per child: child index + 1 is stored in id bits above ms_child_shift, child torrent id - in bits below,
+	/// actions are routed to owning child by that prefix, empty ids lists(all torrents) are sent to every child.
+	///
+	/// Children must be added before connecting, their gui executor is reset:
+	/// they call handlers on their own threads, multi_data_source posts merged results to it's own executor.
+	class multi_data_source :
+		public abstract_data_source,
+		public ext::net::abstract_connection_controller
+	{
+	public:
+		using duration = std::chrono::steady_clock::duration;
+		using source_ptr = std::shared_ptr<abstract_data_source>;
+
+	protected:
+		template <class Data>
+		class merged_subscription;
+
+		struct child_source
+		{
+			source_ptr source;
+			string_type name;
+		};
+
+	protected:
+		std::vector<child_source> m_children;
+		QtTools::gui_executor * m_executor = nullptr;
+
+	protected:
+		void do_connect_request(unique_lock lk) override;
+		void do_disconnect_request(unique_lock lk) override;
+
+	protected:
+		/// posts action to gui executor, or executes it in place if there is no one
+		template <class Action>
+		void post(Action && action);
+
+		/// splits namespaced ids by child, result has size of m_children
+		auto split_ids(const torrent_id_list & ids) const -> std::vector<torrent_id_list>;
+		/// calls method on children owning ids, waits them all
+		template <class Method>
+		auto route_action(torrent_id_list ids, Method method) -> ext::future<void>;
+
+	public:
+		static constexpr unsigned ms_child_shift = 48;
+		static auto make_id(std::size_t child, const torrent_id_type & id) -> torrent_id_type;
+		/// returns child index and child torrent id, throws std::invalid_argument for not namespaced id
+		static auto split_id(const torrent_id_type & id) -> std::pair<std::size_t, torrent_id_type>;
+
+	public:
+		void add_source(source_ptr source, string_type name);
+		auto source_count() const noexcept { return m_children.size(); }
+		auto source(std::size_t idx) const -> const source_ptr & { return m_children[idx].source; }
+		auto source_name(std::size_t idx) const -> const string_type & { return m_children[idx].name; }
+		auto source_latency(std::size_t idx) const -> duration { return m_children[idx].source->last_latency(); }
+
+	public:
+		/// address is configured per child, see add_source
+		void set_address(std::string addr) override {}
+		void set_timeout(std::chrono::steady_clock::duration timeout) override;
+		void set_logger(ext::library_logger::logger * logger) override;
+		void set_gui_executor(QtTools::gui_executor * executor) override { m_executor = executor; }
+		auto get_gui_executor() const -> QtTools::gui_executor * override { return m_executor; }
+
+	public:
+		virtual auto subscribe_session_stats(session_stat_handler handler) -> ext::net::subscription_handle override;
+		virtual ext::future<session_stat> get_session_stats() override;
+
+	public:
+		auto subscribe_torrents(torrent_handler handler) -> ext::net::subscription_handle override;
+
+		virtual ext::future<torrent_list> get_torrents() override;
+		virtual ext::future<torrent_list> get_torrents(torrent_id_list ids) override;
+
+		virtual ext::future<void> start_all_torrents() override;
+		virtual ext::future<void> stop_all_torrents() override;
+
+		virtual ext::future<void> start_torrents(torrent_id_list ids) override;
+		virtual ext::future<void> start_torrents_now(torrent_id_list ids) override;
+		virtual ext::future<void> stop_torrents(torrent_id_list ids) override;
+
+		virtual ext::future<void> verify_torrents(torrent_id_list ids) override;
+		virtual ext::future<void> announce_torrents(torrent_id_list ids) override;
+		virtual ext::future<void> set_torrent_location(torrent_id_type id, std::string newloc, bool move) override;
+
+		virtual ext::future<void> remove_torrents(torrent_id_list ids) override;
+		virtual ext::future<void> purge_torrents(torrent_id_list ids) override;
+
+	public:
+		virtual ext::future<torrent_file_list> get_torrent_files(torrent_id_type id) override;
+		virtual ext::future<torrent_peer_list> get_torrent_peers(torrent_id_type id) override;
+		virtual ext::future<tracker_list> get_trackers(torrent_id_type id) override;
+
+		virtual ext::future<torrent_file_map> get_torrent_files(torrent_id_list ids) override;
+		virtual ext::future<tracker_map> get_trackers(torrent_id_list ids) override;
+
+		virtual ext::future<torrent_detail> get_torrent_detail(torrent_id_type id) override;
+		virtual auto subscribe_torrent_detail(torrent_id_type id, torrent_detail_handler handler) -> ext::net::subscription_handle override;
+		virtual auto subscribe_torrent_peers(torrent_id_type id, torrent_peer_handler handler) -> ext::net::subscription_handle override;
+		virtual auto subscribe_torrent_files(torrent_id_type id, torrent_file_handler handler) -> ext::net::subscription_handle override;
+
+	public:
+		/// errors of children, prefixed with their names
+		virtual std::string last_errormsg() const override;
+		/// worst latency among children
+		virtual auto last_latency() const -> duration override;
+
+	public:
+		multi_data_source() = default;
+		~multi_data_source() = default;
+	};
+}
@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include <memory>
 #include <vector>
+#include <cstdint>
 #include <unordered_map>
 #include <qtor/types.hpp>
 #include <qtor/model_meta.hpp>
@@ -41,6 +42,15 @@ namespace qtor
 		template <class Type> optional<Type> get_item(index_type key) const;
 	};
 
+	/// set of sparse_container items: bit N stands for item with index N, so only indexes below 64 are supported
+	using field_mask = std::uint64_t;
+	constexpr field_mask all_fields = ~field_mask(0);
+
+	constexpr field_mask field_bit(sparse_container::index_type key) noexcept { return field_mask(1) << key; }
+
+	/// items which values differ between c1 and c2, item present in only one of them is changed
+	field_mask changed_fields(const sparse_container & c1, const sparse_container & c2);
+
 
 	/************************************************************************/
 	/*                    sparse_container_meta                             */
@@ -107,7 +117,7 @@ namespace qtor
 		auto type = item_type(key);
 		switch (type)
 		{
-			case Int64:
+			case Int64:  item.set_item(key, qvariant_cast<int64_type>(val)); break;
 
 			case Speed:
 			case Size:
@@ -138,6 +148,7 @@ namespace qtor
 
 	public:
 		bool operator()(const sparse_container & c1, const sparse_container & c2) const;
+		auto key() const noexcept { return m_key; }
 
 		sparse_container_comparator() = default;
 		sparse_container_comparator(sparse_container::index_type key, bool ascending)
@@ -166,6 +177,7 @@ namespace qtor
 		bool matches(const sparse_container & c) const;
 		bool matches(const sparse_container::any_type & val) const;
 		bool always_matches() const noexcept;
+		const auto & items() const noexcept { return m_items; }
 
 		bool operator()(const sparse_container & c) const { return matches(c); }
 		explicit operator bool() const noexcept { return not always_matches(); }
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <unordered_set>
+#include <QtCore/QString>
+
+namespace qtor
+{
+	/// Interner of strings that repeat across many records: creators, comments, errors, tracker urls, peer clients, file paths.
+	/// QString is implicitly shared, so interned copies share single buffer with pool entry,
+	/// and equal interned strings can be compared by buffer pointer, see changed_fields.
+	///
+	/// Pool is owned by parser of single data source, see transmission::data_source, and is not thread safe:
+	/// data source parses all responses on one thread. Interned strings themselves can be passed to other threads as any QString.
+	/// Entries referenced only by pool are dropped by collect, it runs automatically when pool doubles.
+	class string_pool
+	{
+	private:
+		std::unordered_set<QString> m_strings;
+		std::size_t m_collect_threshold = 1024;
+
+		// values last reported to pipeline metrics, they are summed over all pools
+		std::size_t m_reported_size = 0;
+		std::size_t m_reported_shared = 0;
+
+	private:
+		void report(std::size_t size, std::size_t shared);
+
+	public:
+		/// returns pooled string equal to str, sharing its buffer
+		auto intern(const QString & str) -> QString;
+		/// drops strings no longer used outside of pool,
+		/// updates memory saved by sharing: sum of sizes of buffers pooled strings would have without pool
+		void collect();
+
+		auto size() const noexcept { return m_strings.size(); }
+		/// bytes saved by sharing pooled strings, as of last collect
+		auto shared_bytes() const noexcept { return m_reported_shared; }
+
+	public:
+		string_pool() = default;
+		~string_pool();
+
+		string_pool(const string_pool &) = delete;
+		string_pool & operator =(const string_pool &) = delete;
+	};
+
+	/// interns str into pool, if there is one
+	inline auto intern(string_pool * pool, const QString & str) -> QString
+	{
+		return pool ? pool->intern(str) : str;
+	}
+}
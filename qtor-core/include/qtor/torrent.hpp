@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include <utility>
 #include <functional>
+#include <unordered_map>
 #include <boost/preprocessor/if.hpp>
 
 #include <qtor/types.hpp>
@@ -29,7 +30,9 @@ namespace qtor
 	struct tracker_stat;
 	struct session_stat;
 
-	using torrent_id_type = string_type;
+	/// Transmission torrent id, integer unique within daemon.
+	/// Stable identity across daemons and restarts is hash_string - torrent info hash.
+	using torrent_id_type = int64_type;
 	using torrent_id_list = std::vector<torrent_id_type>;
 	using torrent_list = std::vector<torrent>;
 
@@ -37,6 +40,10 @@ namespace qtor
 	using torrent_file_list = std::vector<torrent_file>;
 	using tracker_list = std::vector<tracker_stat>;
 
+	// results of batched requests, keyed by torrent id
+	using torrent_file_map = std::unordered_map<torrent_id_type, torrent_file_list>;
+	using tracker_map = std::unordered_map<torrent_id_type, tracker_list>;
+
 
 	struct torrent_peer
 	{
@@ -57,6 +64,20 @@ namespace qtor
 		double progress;
 	};
 
+	bool operator ==(const torrent_peer & p1, const torrent_peer & p2) noexcept;
+	inline bool operator !=(const torrent_peer & p1, const torrent_peer & p2) noexcept { return not (p1 == p2); }
+
+	/// peer identity within torrent: "address:port"
+	string_type peer_key(const torrent_peer & peer);
+
+	/// difference between two consecutive peer snapshots of a torrent
+	struct torrent_peer_diff
+	{
+		torrent_peer_list added;
+		torrent_peer_list changed;
+		std::vector<string_type> removed; // peer keys, see peer_key
+	};
+
 	struct tracker_stat
 	{
 		string_type host;
@@ -66,7 +87,19 @@ namespace qtor
 
 	struct session_stat
 	{
+		speed_type download_speed = 0;
+		speed_type upload_speed = 0;
+
+		uint64_type torrent_count = 0;
+		uint64_type active_torrent_count = 0;
+		uint64_type paused_torrent_count = 0;
+
+		// transferred during current daemon session
+		size_type downloaded_bytes = 0;
+		size_type uploaded_bytes = 0;
 
+		string_type download_dir;
+		optional<size_type> free_space; // unknown until first free space query
 	};
 
 
@@ -80,8 +113,9 @@ namespace qtor
 
 #define QTOR_TORRENT_FOR_EACH_BASIC_FIELD(F)                                    \
 	/*opt/req, Id, Name, Type, TypeName */                                      \
-	F(QTOR_REQ,   Id,      id,      string, torrent_id_type)                    \
+	F(QTOR_REQ,   Id,      id,      int64,  torrent_id_type)                    \
 	F(QTOR_REQ,   Name,    name,    string, string_type)                        \
+	F(QTOR_OPT,   HashString, hash_string, string, string_type)                 \
 	F(QTOR_OPT,   Creator, creator, string, string_type)                        \
 	F(QTOR_OPT,   Comment, comment, string, string_type)                        \
 
@@ -0,0 +1,135 @@
+#pragma once
+#include <map>
+#include <array>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <qtor/torrent.hpp>
+#include <qtor/torrent_category.hpp>
+#include <qtor/torrent_store.hpp>
+#include <boost/signals2/connection.hpp>
+
+namespace qtor
+{
+	/// count, sum, min and max of one numeric torrent field over set of torrents,
+	/// torrents without that field are not counted. min and max are filled only for ordered fields, see torrent_aggregate
+	struct field_stats
+	{
+		std::size_t count = 0;
+		double sum = 0;
+		double min = 0;
+		double max = 0;
+
+		double mean() const noexcept { return count ? sum / count : 0.0; }
+	};
+
+	/// Aggregates of chosen fields over set of torrents, updated by deltas.
+	/// Aggregate does not track its members: owner adds and removes torrent contributions,
+	/// removing exactly values it has added before.
+	/// Sums are exact for integral fields while they stay below 2^53.
+	/// Additive fields keep only sum and count, add and remove are O(1) for them.
+	/// Ordered fields additionally keep value counts for min/max, equal values(like zero speeds) share one entry,
+	/// so add, remove and read stay O(log n) whatever extreme leaves.
+	class torrent_aggregate
+	{
+	public:
+		using index_type = sparse_container::index_type;
+		using value_list = std::vector<optional<double>>;
+
+	private:
+		struct field_state
+		{
+			double sum = 0;
+			std::size_t count = 0;
+			bool ordered = false;
+			// value -> number of torrents having it, only for ordered fields
+			std::map<double, std::size_t> values;
+		};
+
+		std::vector<index_type> m_fields;
+		std::vector<field_state> m_states;
+		std::size_t m_torrent_count = 0;
+
+	public:
+		/// adds or removes torrent contribution, values are in order of fields
+		void add(const value_list & values);
+		void remove(const value_list & values);
+		void clear();
+
+		auto fields() const noexcept -> const std::vector<index_type> & { return m_fields; }
+		auto torrent_count() const noexcept { return m_torrent_count; }
+		/// stats of field, field must be one of aggregated ones, otherwise empty stats are returned
+		auto stats(index_type field) const -> field_stats;
+
+	public:
+		torrent_aggregate() = default;
+		/// ordered_fields - subset of fields min/max are needed for
+		torrent_aggregate(std::vector<index_type> fields, const std::vector<index_type> & ordered_fields = {});
+	};
+
+	/// Keeps torrent_aggregate's of chosen fields attached to torrent_store:
+	/// over all torrents, per torrent_category, and over current selection.
+	/// torrent_category::all is served by total aggregate, it is not kept twice.
+	/// Aggregates are maintained from store update/erase notifications by deltas,
+	/// only torrents with changed aggregated or category fields are recounted, reading is O(1).
+	class torrent_aggregator
+	{
+	public:
+		using index_type = torrent_aggregate::index_type;
+		using value_list = torrent_aggregate::value_list;
+
+	protected:
+		std::shared_ptr<torrent_store> m_store;
+		std::vector<index_type> m_fields;
+		field_mask m_fields_mask = 0;
+
+		struct entry
+		{
+			/// categories torrent is currently counted in
+			torrent_category_set categories;
+			bool selected = false;
+			/// values counted in aggregates, single copy shared by all of them
+			value_list values;
+		};
+
+		std::unordered_map<const torrent *, entry> m_entries;
+		torrent_aggregate m_total;
+		// indexed by category - 1, all category is m_total
+		std::array<torrent_aggregate, torrent_category::count - 1> m_categories;
+		torrent_aggregate m_selection;
+		std::unordered_set<torrent_id_type> m_selected_ids;
+
+		boost::signals2::scoped_connection m_update_conn;
+		boost::signals2::scoped_connection m_erase_conn;
+		boost::signals2::scoped_connection m_clear_conn;
+
+	protected:
+		void insert(const torrent * ptr);
+		void erase(const torrent * ptr);
+		void reset();
+		/// adds or removes entry values from total, categories and selection aggregates
+		void account(const entry & e, bool add);
+
+		template <class Range> void on_update(const Range & erased, const Range & updated, const Range & inserted);
+
+	public:
+		/// speeds, sizes, ever uploaded/downloaded and ratio
+		static auto default_fields() -> std::vector<index_type>;
+
+		auto total() const noexcept -> const torrent_aggregate & { return m_total; }
+		auto category(torrent_category_type cat) const -> const torrent_aggregate & { return cat == torrent_category::all ? m_total : m_categories[cat - 1]; }
+		auto selection() const noexcept -> const torrent_aggregate & { return m_selection; }
+
+		/// replaces current selection, O(old + new selection size)
+		void set_selection(const torrent_id_list & ids);
+
+	public:
+		/// ordered_fields - subset of fields min/max are needed for, by default none: consumers use sums only
+		torrent_aggregator(std::shared_ptr<torrent_store> store, std::vector<index_type> fields = default_fields(), std::vector<index_type> ordered_fields = {});
+
+		torrent_aggregator(const torrent_aggregator &) = delete;
+		torrent_aggregator & operator =(const torrent_aggregator &) = delete;
+	};
+}
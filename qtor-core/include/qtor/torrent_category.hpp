@@ -0,0 +1,33 @@
+#pragma once
+#include <qtor/torrent.hpp>
+#include <ext/enum_bitset.hpp>
+
+namespace qtor
+{
+	/// Torrent categories as shown by category list, torrent usually belongs to several of them.
+	namespace torrent_category
+	{
+		enum type : unsigned
+		{
+			all,
+			downloading,
+			downloaded,
+			active,
+			nonactive,
+			stopped,
+			error,
+
+			count
+		};
+	}
+
+	using torrent_category_type = torrent_category::type;
+	using torrent_category_set = ext::enum_bitset<torrent_category_type, torrent_category::count>;
+
+	/// torrent fields torrent_categories depends on
+	constexpr field_mask torrent_category_fields =
+		field_bit(torrent::Status) | field_bit(torrent::ErrorString) |
+		field_bit(torrent::CurrentSize) | field_bit(torrent::RequestedSize);
+
+	torrent_category_set torrent_categories(const torrent & torr) noexcept;
+}
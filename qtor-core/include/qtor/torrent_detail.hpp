@@ -0,0 +1,16 @@
+#pragma once
+#include <qtor/torrent.hpp>
+#include <qtor/torrent_file.hpp>
+
+namespace qtor
+{
+	/// Detail snapshot of single torrent: files, trackers and peers,
+	/// everything detail views need, retrieved in one request.
+	struct torrent_detail
+	{
+		torrent_id_type   id;
+		torrent_file_list files;
+		tracker_list      trackers;
+		torrent_peer_list peers;
+	};
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <qtor/torrent_detail.hpp>
+#include <qtor/view_manager.hpp>
+#include <qtor/abstract_data_source.hpp>
+#include <boost/signals2.hpp>
+
+namespace qtor
+{
+	/// Holds last detail snapshot of a torrent.
+	/// Store is associated with torrent detail subscription, which is refreshed at fast rate,
+	/// and as torrent_store automatically pauses subscription if there are no connected views.
+	class torrent_detail_store : public view_manager
+	{
+	public:
+		using update_signal = boost::signals2::signal<void (const torrent_detail & detail)>;
+
+	protected:
+		torrent_id_type m_torrent_id;
+		torrent_detail m_detail;
+		std::shared_ptr<abstract_data_source> m_source;
+
+		update_signal m_onupdate_signal;
+
+	protected:
+		auto subscribe() -> ext::net::subscription_handle override;
+		virtual void assign(torrent_detail & detail);
+
+	public:
+		auto torrent_id() const -> const torrent_id_type & { return m_torrent_id; }
+		auto detail()     const -> const torrent_detail & { return m_detail; }
+
+		/// called with new snapshot each time subscription delivers it
+		template <class ... Args>
+		auto on_update(Args && ... args) { return m_onupdate_signal.connect(std::forward<Args>(args)...); }
+
+	public:
+		torrent_detail_store(torrent_id_type torrent_id, std::shared_ptr<abstract_data_source> source);
+		~torrent_detail_store();
+	};
+}
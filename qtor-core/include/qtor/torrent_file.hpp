@@ -39,6 +39,27 @@ namespace qtor
 	};
 
 
+	/// changeable part of torrent_file, transmission fileStats entry.
+	/// Position in torrent_file_stat_list is file index
+	struct torrent_file_stat
+	{
+		size_type     have_size;
+		int_type      priority;
+		bool          wanted;
+	};
+
+	using torrent_file_stat_list = std::vector<torrent_file_stat>;
+
+	/// torrent files subscription update: either full file list,
+	/// or just stats of already known files, applied positionally by torrent_file::index
+	struct torrent_file_update
+	{
+		bool full = false;
+		torrent_file_list files;       // if full
+		torrent_file_stat_list stats;  // if not full
+	};
+
+
 	struct torrent_file_id_hasher
 	{
 		auto operator()(const torrent_file & val) const noexcept
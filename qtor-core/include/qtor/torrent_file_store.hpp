@@ -1,16 +1,22 @@
 #pragma once
 #include <qtor/torrent_file.hpp>
+#include <qtor/view_manager.hpp>
 #include <qtor/abstract_data_source.hpp>
 #include <viewed/hash_container.hpp>
 #include <boost/multi_index/member.hpp>
 
 namespace qtor
 {
+	/// Hash store of files of a torrent, keyed by file path.
+	/// Store is associated with files subscription: full file list is received once,
+	/// after that only file stats are received and applied by file index.
+	/// As torrent_store it automatically pauses subscription if there are no connected views.
 	class torrent_file_store :
 		public viewed::hash_container<
 			torrent_file,
 	        boost::multi_index::member<torrent_file, filepath_type, &torrent_file::filename>
-		>
+		>,
+		public view_manager
 	{
 		using base_type = viewed::hash_container<
 			torrent_file,
@@ -20,11 +26,24 @@ namespace qtor
 	protected:
 		torrent_id_type m_torrent_id;
 		std::shared_ptr<abstract_data_source> m_source;
+		/// file paths by torrent_file::index, stats are matched with files through it
+		std::vector<filepath_type> m_by_index;
+		/// updates received within frame merged together, applied on next frame, see update_scheduler
+		optional<torrent_file_update> m_pending_update;
 
-	public:
-		auto torrent_id() { return m_torrent_id; }
+	protected:
+		auto subscribe() -> ext::net::subscription_handle override;
+		/// merges update into pending one and schedules it
+		void post_update(torrent_file_update & update);
+		void flush_pending();
 
 	public:
+		auto torrent_id() const -> const torrent_id_type & { return m_torrent_id; }
+
+		/// full update replaces all files, otherwise stats are applied to files with corresponding index,
+		/// only files with actually changed stats are upserted
+		void apply_update(torrent_file_update & update);
+		/// one time request of full file list, independent of subscription
 		void refresh();
 
 	public:
@@ -44,16 +63,12 @@ namespace qtor
 	public:
 		torrent_file_store(torrent_id_type torrent_id, std::shared_ptr<abstract_data_source> source);
 		torrent_file_store(const torrent torrent, std::shared_ptr<abstract_data_source> source);
-		~torrent_file_store() = default;
+		~torrent_file_store();
 	};
 
 	inline torrent_file_store::torrent_file_store(const torrent torrent, std::shared_ptr<abstract_data_source> source)
 	    : torrent_file_store(torrent.id(), std::move(source)) {}
 
-
-	inline torrent_file_store::torrent_file_store(torrent_id_type torrent_id, std::shared_ptr<abstract_data_source> source)
-		: m_source(std::move(source)) {}
-
 	template <class RecordRange>
 	void torrent_file_store::upsert_records(RecordRange newRecs)
 	{
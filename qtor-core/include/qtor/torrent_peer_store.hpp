@@ -0,0 +1,40 @@
+#pragma once
+#include <qtor/torrent.hpp>
+#include <qtor/view_manager.hpp>
+#include <qtor/abstract_data_source.hpp>
+#include <viewed/hash_container.hpp>
+#include <boost/multi_index/global_fun.hpp>
+
+namespace qtor
+{
+	/// Hash store of peers of a torrent, keyed by peer_key.
+	/// Store is associated with peers subscription and is updated incrementally by peer diffs,
+	/// as torrent_store it automatically pauses subscription if there are no connected views.
+	class torrent_peer_store :
+		public viewed::hash_container<
+			torrent_peer, boost::multi_index::global_fun<const torrent_peer &, string_type, &peer_key>
+		>,
+		public view_manager
+	{
+		typedef viewed::hash_container<
+			torrent_peer, boost::multi_index::global_fun<const torrent_peer &, string_type, &peer_key>
+		> base_type;
+
+	protected:
+		torrent_id_type m_torrent_id;
+		std::shared_ptr<abstract_data_source> m_source;
+
+	protected:
+		auto subscribe() -> ext::net::subscription_handle override;
+
+	public:
+		auto torrent_id() const -> const torrent_id_type & { return m_torrent_id; }
+
+		/// applies diff: removed peers are erased, added and changed are upserted
+		void apply_diff(torrent_peer_diff & diff);
+
+	public:
+		torrent_peer_store(torrent_id_type torrent_id, std::shared_ptr<abstract_data_source> source);
+		~torrent_peer_store();
+	};
+}
@@ -0,0 +1,135 @@
+#pragma once
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+#include <qtor/torrent.hpp>
+
+namespace qtor
+{
+	/// Versioned binary torrent_list snapshot, designed to be memory mapped and read in place.
+	///
+	/// Layout, all offsets are from file start, all sections are 8 byte aligned, integers are native(little endian):
+	///   header               - magic, version, counts, section offsets
+	///   field table          - one entry per stored torrent field: name, meta type, column offsets
+	///   columns              - per field: 8 byte value per torrent + presence bitmap, 1 bit per torrent
+	///   string heap          - UTF-16 characters, string values are (offset, length) pairs into it
+	///
+	/// Numbers are stored as is, bool as 0/1, datetime as nanoseconds since epoch, duration as nanoseconds.
+	/// Fields are matched by name on reading, so snapshots survive adding/reordering torrent fields.
+	namespace torrent_snapshot_format
+	{
+		constexpr char magic[8] = {'Q', 'T', 'O', 'R', 'S', 'N', 'A', 'P'};
+		constexpr std::uint32_t version = 1;
+
+		struct header
+		{
+			char magic[8];
+			std::uint32_t version;
+			std::uint32_t field_count;
+			std::uint64_t torrent_count;
+			std::uint64_t fields_offset;
+			std::uint64_t heap_offset;
+			std::uint64_t heap_size;    // in UTF-16 characters
+		};
+
+		struct field_entry
+		{
+			std::uint32_t type;         // model_meta type
+			std::uint32_t name_offset;  // UTF-16 characters in heap
+			std::uint32_t name_length;
+			std::uint32_t reserved;
+			std::uint64_t values_offset;
+			std::uint64_t presence_offset;
+		};
+
+		struct string_ref
+		{
+			std::uint32_t offset;
+			std::uint32_t length;
+		};
+	}
+
+	/// writes torrents as binary snapshot, throws std::runtime_error on io errors
+	void write_torrent_snapshot(const QString & path, const torrent_list & torrents);
+
+	/// Read only view of binary snapshot file, file is memory mapped, fields are accessed without copying.
+	/// Strings returned by get_string reference mapped memory and are valid while snapshot is alive,
+	/// to_torrent/to_torrent_list produce independent copies.
+	class torrent_snapshot
+	{
+	public:
+		using index_type = sparse_container::index_type;
+
+	protected:
+		struct column
+		{
+			unsigned type = model_meta::Unknown;
+			const std::uint64_t * values = nullptr;
+			const std::uint64_t * presence = nullptr;
+		};
+
+	protected:
+		QFile m_file;
+		const uchar * m_data = nullptr;
+		std::size_t m_size = 0;
+
+		const torrent_snapshot_format::header * m_header = nullptr;
+		const char16_t * m_heap = nullptr;
+		/// by torrent field index, fields absent in snapshot or of other type have no values
+		std::vector<column> m_columns;
+
+	protected:
+		/// value slot of torrent field, nullptr if torrent has no such field
+		auto raw(std::size_t row, index_type key) const noexcept -> const std::uint64_t *;
+		void validate_and_index();
+
+	public:
+		auto size() const noexcept -> std::size_t { return m_header->torrent_count; }
+		bool has_field(index_type key) const noexcept { return key < m_columns.size() and m_columns[key].values; }
+
+		/// numeric field value, Type is type of torrent accessor for this field(uint64_type, double, datetime_type, ...)
+		template <class Type>
+		auto get(std::size_t row, index_type key) const -> optional<Type>;
+		/// zero copy string, references mapped memory
+		auto get_string(std::size_t row, index_type key) const -> optional<QString>;
+
+		auto to_torrent(std::size_t row) const -> torrent;
+		auto to_torrent_list() const -> torrent_list;
+
+	public:
+		/// maps file, throws std::runtime_error if file can't be opened or is not valid snapshot
+		torrent_snapshot(const QString & path);
+
+		torrent_snapshot(const torrent_snapshot &) = delete;
+		torrent_snapshot & operator =(const torrent_snapshot &) = delete;
+	};
+
+	template <class Type>
+	auto torrent_snapshot::get(std::size_t row, index_type key) const -> optional<Type>
+	{
+		auto * ptr = raw(row, key);
+		if (not ptr) return nullopt;
+
+		auto val = *ptr;
+		if constexpr (std::is_same_v<Type, double>)
+		{
+			double result;
+			std::memcpy(&result, &val, sizeof(result));
+			return result;
+		}
+		else if constexpr (std::is_same_v<Type, datetime_type>)
+			return datetime_type(std::chrono::duration_cast<datetime_type::duration>(std::chrono::nanoseconds(static_cast<std::int64_t>(val))));
+		else if constexpr (std::is_same_v<Type, duration_type>)
+			return std::chrono::duration_cast<duration_type>(std::chrono::nanoseconds(static_cast<std::int64_t>(val)));
+		else
+		{
+			static_assert(std::is_integral_v<Type>, "unsupported snapshot field type");
+			return static_cast<Type>(val);
+		}
+	}
+}
@@ -2,6 +2,9 @@
 #include <qtor/torrent.hpp>
 #include <qtor/view_manager.hpp>
 #include <qtor/abstract_data_source.hpp>
+#include <qtor/tracing.hpp>
+#include <qtor/metrics.hpp>
+#include <unordered_map>
 #include <viewed/hash_container.hpp>
 #include <boost/multi_index/mem_fun.hpp>
 
@@ -21,11 +24,50 @@ namespace qtor
 			torrent, boost::multi_index::const_mem_fun<torrent, torrent_id_type, &torrent::id>
 		> base_type;
 
+		static_assert(torrent::LastField <= 64, "torrent fields must fit field_mask");
+
 	protected:
 		std::shared_ptr<abstract_data_source> m_source;
 
+		/// fields changed by last upsert/assign, per torrent and union of all, new torrents have all_fields.
+		/// Views read them while handling update notification to skip resorting and repaint only changed cells
+		std::unordered_map<torrent_id_type, field_mask> m_changed;
+		field_mask m_changed_union = 0;
+
+		/// torrent id -> generation of last snapshot it was seen in, see reconcile_records
+		std::unordered_map<torrent_id_type, unsigned> m_seen;
+		unsigned m_generation = 0;
+
+		/// subscription snapshot reduced to what reconcile needs:
+		/// ids of all its torrents and copies of torrents differing from stored ones
+		struct pending_snapshot
+		{
+			torrent_id_list ids;
+			torrent_list changed;
+			std::size_t unchanged = 0;
+		};
+
+		/// latest subscription snapshot waiting for next frame, see update_scheduler
+		optional<pending_snapshot> m_pending_snapshot;
+
 	protected:
 		auto subscribe() -> ext::net::subscription_handle override;
+		/// reconciles store with pending snapshot, if any
+		void flush_pending();
+
+		/// computes changed fields of records against stored ones into m_changed
+		template <class RecordRange>
+		void compute_changes(const RecordRange & newRecs);
+
+	public:
+		/// false until first live snapshot is applied: store holds only warm start rows, if any,
+		/// ids of which may refer to other torrents by now
+		bool is_live() const noexcept { return m_generation != 0; }
+
+		/// fields changed by last update, valid during update notification and until next one
+		auto last_changed_fields() const noexcept { return m_changed_union; }
+		auto last_changed_fields(torrent_id_type id) const -> field_mask;
+
 
 	public:
 		/// добавляет данные. Уже имеющиеся данные обновляются, остальные добавляются
@@ -41,21 +83,126 @@ namespace qtor
 		template <class RecordRange>
 		void assign_records(RecordRange newRecs);
 
+		/// newRecs is full snapshot of all torrents: present ones are upserted, missing ones are erased.
+		/// Unlike assign_records only changed records are passed further, usually resulting in single update notification,
+		/// erase notification happens only if some torrents were removed
+		template <class RecordRange>
+		void reconcile_records(RecordRange newRecs);
+
+		/// same as above for snapshot given by ids of all it's torrents and records which may differ from stored ones,
+		/// torrents not listed in changedRecs are considered unchanged
+		template <class RecordRange>
+		void reconcile_records(const torrent_id_list & ids, RecordRange changedRecs);
+
 	public:
 		torrent_store(std::shared_ptr<abstract_data_source> source);
-		~torrent_store() = default;
+		~torrent_store();
 	};
 
 
 	template <class RecordRange>
 	void torrent_store::upsert_records(RecordRange newRecs)
 	{
-		upsert(std::make_move_iterator(newRecs.begin()), std::make_move_iterator(newRecs.end()));
+		QTOR_TRACE_SCOPE("torrent_store::upsert_records");
+		metrics::pipeline().upsert_batch_size.record(std::distance(newRecs.begin(), newRecs.end()));
+		compute_changes(newRecs);
+
+		// no-op updates are not passed further at all: views are not notified about them
+		torrent_list changed;
+		for (auto & rec : newRecs)
+		{
+			m_seen.try_emplace(rec.id(), m_generation);
+			if (m_changed.count(rec.id()))
+				changed.push_back(std::move(rec));
+		}
+
+		metrics::pipeline().upsert_unchanged.add(std::distance(newRecs.begin(), newRecs.end()) - changed.size());
+		if (changed.empty()) return;
+
+		upsert(std::make_move_iterator(changed.begin()), std::make_move_iterator(changed.end()));
 	}
 
 	template <class RecordRange>
 	void torrent_store::assign_records(RecordRange newRecs)
 	{
+		QTOR_TRACE_SCOPE("torrent_store::assign_records");
+		metrics::pipeline().upsert_batch_size.record(std::distance(newRecs.begin(), newRecs.end()));
+		compute_changes(newRecs);
+
+		m_seen.clear();
+		for (auto & rec : newRecs)
+			m_seen.emplace(rec.id(), m_generation);
+
 		assign(std::make_move_iterator(newRecs.begin()), std::make_move_iterator(newRecs.end()));
 	}
+
+	template <class RecordRange>
+	void torrent_store::reconcile_records(RecordRange newRecs)
+	{
+		torrent_id_list ids;
+		for (auto & rec : newRecs)
+			ids.push_back(rec.id());
+
+		reconcile_records(ids, std::move(newRecs));
+	}
+
+	template <class RecordRange>
+	void torrent_store::reconcile_records(const torrent_id_list & ids, RecordRange changedRecs)
+	{
+		QTOR_TRACE_SCOPE("torrent_store::reconcile_records");
+
+		auto generation = ++m_generation;
+		for (auto & id : ids)
+			m_seen[id] = generation;
+
+		// whatever was not touched by this snapshot is gone from daemon
+		torrent_id_list stale;
+		for (auto it = m_seen.begin(); it != m_seen.end();)
+		{
+			if (it->second == generation)
+				++it;
+			else
+			{
+				stale.push_back(it->first);
+				it = m_seen.erase(it);
+			}
+		}
+
+		// ids are unique only within daemon session: after daemon restart, or for warm start snapshot rows,
+		// same id can denote other torrent. Such records are replaced, not merged - torrents are matched by hash.
+		// Hash change is a field change, so only changed records are checked
+		for (auto & rec : changedRecs)
+		{
+			auto it = find(rec.id());
+			if (it == end()) continue;
+
+			auto old_hash = it->hash_string();
+			auto new_hash = rec.hash_string();
+			if (old_hash and new_hash and *old_hash != *new_hash)
+				stale.push_back(rec.id());
+		}
+
+		if (not stale.empty())
+			erase(stale.begin(), stale.end());
+
+		upsert_records(std::move(changedRecs));
+	}
+
+	template <class RecordRange>
+	void torrent_store::compute_changes(const RecordRange & newRecs)
+	{
+		m_changed.clear();
+		m_changed_union = 0;
+
+		for (const auto & rec : newRecs)
+		{
+			auto id = rec.id();
+			auto it = find(id);
+			auto mask = it == end() ? all_fields : changed_fields(*it, rec);
+			if (not mask) continue;
+
+			m_changed.emplace(id, mask);
+			m_changed_union |= mask;
+		}
+	}
 }
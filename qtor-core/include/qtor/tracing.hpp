@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <string>
+#include <cstdint>
+
+/// Lightweight scoped trace spans.
+/// Spans are written into per thread ring buffers, no locks are taken on hot path.
+/// Collected spans can be exported as Chrome trace event json, viewable by chrome://tracing or Perfetto.
+///
+/// When tracing is disabled span costs one relaxed atomic load.
+/// Defining QTOR_DISABLE_TRACING removes spans at compile time.
+///
+/// Usage:
+///   QTOR_TRACE_SCOPE("torrent_store::upsert_records");
+/// span name must be a string literal or otherwise have static storage duration.
+
+namespace qtor::tracing
+{
+	/// nanoseconds since tracing epoch(process start), steady clock
+	std::int64_t now() noexcept;
+
+	/// enables/disables span recording, already recorded spans are kept
+	void enable(bool enable = true) noexcept;
+	inline bool enabled() noexcept;
+
+	/// records complete span [start, end] of current thread
+	void record(const char * name, std::int64_t start, std::int64_t end) noexcept;
+	/// sets name of current thread, shown in exported trace
+	void set_thread_name(std::string name);
+
+	/// drops all recorded spans
+	void clear();
+	/// recorded spans of all threads as Chrome trace event json document.
+	/// Spans recorded concurrently with export are either exported or skipped.
+	std::string export_chrome_trace();
+	/// writes export_chrome_trace to file, returns false on failure
+	bool write_chrome_trace(const std::string & path);
+
+	/// RAII span, records time between construction and destruction
+	class scoped_span
+	{
+	private:
+		const char * m_name;
+		std::int64_t m_start;
+
+	public:
+		scoped_span(const char * name) noexcept
+			: m_name(enabled() ? name : nullptr), m_start(m_name ? now() : 0) {}
+
+		~scoped_span() noexcept
+		{
+			if (m_name) record(m_name, m_start, now());
+		}
+
+		scoped_span(const scoped_span &) = delete;
+		scoped_span & operator =(const scoped_span &) = delete;
+	};
+
+
+	extern std::atomic<bool> g_enabled;
+
+	inline bool enabled() noexcept
+	{
+		return g_enabled.load(std::memory_order_relaxed);
+	}
+}
+
+#define QTOR_TRACE_CONCAT_IMPL(a, b) a##b
+#define QTOR_TRACE_CONCAT(a, b) QTOR_TRACE_CONCAT_IMPL(a, b)
+
+#ifndef QTOR_DISABLE_TRACING
+#define QTOR_TRACE_SCOPE(name) ::qtor::tracing::scoped_span QTOR_TRACE_CONCAT(qtor_trace_span_, __LINE__) {name}
+#else
+#define QTOR_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
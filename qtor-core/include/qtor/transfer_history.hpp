@@ -0,0 +1,104 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+
+#include <qtor/torrent.hpp>
+#include <qtor/torrent_store.hpp>
+#include <boost/signals2/connection.hpp>
+
+namespace qtor
+{
+	/// Compact speed history of torrents, kept alongside torrent_store, source for speed graphs.
+	///
+	/// Each torrent has fixed capacity ring buffers of download/upload speed in 3 tiers:
+	/// per second, per minute and per hour samples, coarser tiers are averages of finer ones.
+	/// Samples are 16 bit log quantised speeds: 1024 steps per octave, relative error is below 0.07%.
+	/// All torrents share same tick, so ring positions are global, and all rings live in single arena,
+	/// torrent occupies fixed slot of it: (300 + 120 + 48) * 2 samples * 2 bytes, less than 2KB.
+	/// Slot 0 is reserved for sum of all torrents speeds.
+	///
+	/// Samples are taken on store updates, gaps between them are filled with current speeds.
+	class transfer_history
+	{
+	public:
+		using clock_type = std::chrono::steady_clock;
+		using sample_type = std::uint16_t;
+		using speed_sample = std::array<float, 2>;
+
+		enum direction_type : unsigned { download, upload, direction_count };
+		enum tier_type : unsigned { seconds, minutes, hours, tier_count };
+
+		static constexpr std::array<unsigned, tier_count> tier_capacity = {300, 120, 48};
+		/// how many samples of previous tier make one sample of tier
+		static constexpr std::array<unsigned, tier_count> tier_ratio = {1, 60, 60};
+
+		static auto quantize(speed_type speed) noexcept -> sample_type;
+		static auto dequantize(sample_type sample) noexcept -> speed_type;
+
+	protected:
+		static constexpr unsigned ms_samples_per_direction = tier_capacity[seconds] + tier_capacity[minutes] + tier_capacity[hours];
+		static constexpr unsigned ms_slot_size = ms_samples_per_direction * direction_count;
+		static constexpr unsigned ms_total_slot = 0;
+
+		/// running sums of finer tier samples, not yet flushed into coarser tier
+		struct accumulator
+		{
+			std::array<speed_sample, tier_count> sums = {};
+		};
+
+	protected:
+		std::shared_ptr<torrent_store> m_store;
+
+		std::vector<sample_type> m_arena;
+		std::vector<accumulator> m_accumulators;
+		/// m_pushed at time slot was taken, older samples belong to previous owner
+		std::vector<std::array<std::uint64_t, tier_count>> m_born;
+		std::vector<unsigned> m_free_slots;
+		/// torrents are updated in place by store, so pointer is stable key until erased
+		std::unordered_map<const torrent *, unsigned> m_slots;
+
+		/// ring heads: position next sample of tier goes to
+		std::array<unsigned, tier_count> m_heads = {};
+		/// samples pushed into each tier so far
+		std::array<std::uint64_t, tier_count> m_pushed = {};
+		clock_type::time_point m_last_sample;
+
+		boost::signals2::scoped_connection m_update_conn;
+		boost::signals2::scoped_connection m_erase_conn;
+		boost::signals2::scoped_connection m_clear_conn;
+
+	protected:
+		static auto tier_offset(direction_type dir, tier_type tier) noexcept -> unsigned;
+
+		auto acquire_slot(const torrent * ptr) -> unsigned;
+		void release_slot(const torrent * ptr);
+		void release_all();
+
+		/// pushes sample of every slot into tier, cascading averages into coarser tiers
+		void push(tier_type tier, const std::vector<speed_sample> & speeds);
+		auto read(unsigned slot, direction_type dir, tier_type tier) const -> std::vector<speed_type>;
+
+	public:
+		/// samples current speeds of all torrents for every whole second passed since last sample.
+		/// Called automatically on store updates, catch up after long gap is limited by seconds tier capacity
+		void sample(clock_type::time_point now = clock_type::now());
+
+		/// speed history of torrent, oldest sample first, empty for unknown torrent
+		auto history(torrent_id_type id, direction_type dir, tier_type tier) const -> std::vector<speed_type>;
+		/// speed history of all torrents summed
+		auto total_history(direction_type dir, tier_type tier) const -> std::vector<speed_type>;
+
+		auto tracked_torrents() const noexcept { return m_slots.size(); }
+		auto memory_usage() const noexcept -> std::size_t;
+
+	public:
+		transfer_history(std::shared_ptr<torrent_store> store);
+
+		transfer_history(const transfer_history &) = delete;
+		transfer_history & operator =(const transfer_history &) = delete;
+	};
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <chrono>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <QtCore/QTimer>
+
+namespace qtor
+{
+	/// Paces store updates to display frames.
+	/// Stores post keyed flush actions instead of applying incoming data immediately,
+	/// action posted again with same key before flush replaces pending one.
+	/// Pending actions are run together at most once per frame interval,
+	/// so bursts of updates(initial load, reconnect, replay) reach models as single update per frame.
+	/// Must be used from gui thread.
+	class update_scheduler
+	{
+	public:
+		using action_type = std::function<void()>;
+		using key_type = const void *;
+
+	private:
+		QTimer m_timer;
+		std::chrono::milliseconds m_frame_interval = std::chrono::milliseconds(16);
+		std::chrono::steady_clock::time_point m_last_flush;
+		std::vector<std::pair<key_type, action_type>> m_pending;
+		/// actions of flush in progress, cancel resets not yet run ones
+		std::vector<std::pair<key_type, action_type>> * m_running = nullptr;
+
+	public:
+		/// schedules action for next frame, returns false if pending action of key was replaced
+		bool post(key_type key, action_type action);
+		/// drops pending action of key, stores call it on destruction.
+		/// Can be called from within flush, action of key is dropped even if it is in currently running batch
+		void cancel(key_type key);
+		/// runs all pending actions now, in order they were first posted
+		void flush();
+
+		void set_frame_interval(std::chrono::milliseconds interval) { m_frame_interval = interval; }
+		auto get_frame_interval() const noexcept { return m_frame_interval; }
+
+	public:
+		/// gui thread scheduler
+		static update_scheduler & instance();
+
+	public:
+		update_scheduler();
+
+		update_scheduler(const update_scheduler &) = delete;
+		update_scheduler & operator =(const update_scheduler &) = delete;
+	};
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <memory>
+#include <utility>
 #include <ext/net/subscription_handle.hpp>
 
 namespace qtor
@@ -8,9 +10,17 @@ namespace qtor
 	protected:
 		unsigned m_viewcount = 0;
 		ext::net::subscription_handle m_subsription_handle;
+		/// expires with store, see guarded
+		std::shared_ptr<void> m_alive = std::make_shared<bool>(true);
 
 	protected:
 		virtual auto subscribe() -> ext::net::subscription_handle = 0;
+
+		/// Wraps subscription handler, so it does nothing once store is destroyed.
+		/// Closing subscription does not drop deliveries already posted to gui executor,
+		/// those still can run after store is gone. Must be invoked from gui thread, same as store is destroyed from.
+		template <class Handler>
+		auto guarded(Handler handler) const;
 		virtual void start_subscription();
 		virtual void stop_subscription();
 
@@ -24,6 +34,17 @@ namespace qtor
 	};
 
 
+	template <class Handler>
+	auto view_manager::guarded(Handler handler) const
+	{
+		return [alive = std::weak_ptr<void>(m_alive), handler = std::move(handler)](auto && ... args) mutable
+		{
+			if (not alive.expired())
+				handler(std::forward<decltype(args)>(args)...);
+		};
+	}
+
+
 	/// similar to std::shared_ptr, but has unique_ptr semantics,
 	/// and calls view_addref, view_release on acquire/release operations
 	template <class Store>
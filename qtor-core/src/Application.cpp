@@ -66,12 +66,35 @@ namespace qtor
 		m_notificationCenter->AddError(title, body);
 	}
 
+	void Application::OnSessionStat(session_stat & stat)
+	{
+		Q_EMIT SessionStatUpdated(stat);
+	}
+
 	auto Application::AccquireTorrentModel() -> abstract_torrent_model_ptr
 	{
 		assert(m_source);
 		return std::make_shared<TorrentsModel>(m_torrent_store);
 	}
 
+	auto Application::AccquireTorrentDetailStore(torrent_id_type id) -> torrent_detail_store_ptr
+	{
+		assert(m_source);
+		return std::make_shared<torrent_detail_store>(std::move(id), m_source);
+	}
+
+	auto Application::AccquireTorrentPeerStore(torrent_id_type id) -> torrent_peer_store_ptr
+	{
+		assert(m_source);
+		return std::make_shared<torrent_peer_store>(std::move(id), m_source);
+	}
+
+	auto Application::AccquireTorrentFileStore(torrent_id_type id) -> torrent_file_store_ptr
+	{
+		assert(m_source);
+		return std::make_shared<torrent_file_store>(std::move(id), m_source);
+	}
+
 	auto Application::GetSource() -> abstract_data_source_ptr
 	{
 		if (not m_source)
@@ -86,6 +109,9 @@ namespace qtor
 		m_source->on_event([this](auto ev) { OnSourceEvent(ev); });
 		m_source->set_gui_executor(m_executor);
 		m_torrent_store = std::make_shared<torrent_store>(m_source);
+		m_torrent_aggregator = std::make_shared<torrent_aggregator>(m_torrent_store);
+		m_transfer_history = std::make_shared<transfer_history>(m_torrent_store);
+		m_session_stat_handle = m_source->subscribe_session_stats([this](session_stat & stat) { OnSessionStat(stat); });
 
 		connect(this, &Application::ConnectionError, this, &Application::OnConnectionError);
 	}
@@ -98,6 +124,22 @@ namespace qtor
 		return m_torrent_store;
 	}
 
+	auto Application::GetAggregator() -> torrent_aggregator_ptr
+	{
+		if (not m_torrent_aggregator)
+			Init();
+
+		return m_torrent_aggregator;
+	}
+
+	auto Application::GetTransferHistory() -> transfer_history_ptr
+	{
+		if (not m_transfer_history)
+			Init();
+
+		return m_transfer_history;
+	}
+
 	void Application::OnTorrentsStarted(ext::future<void> result, torrent_id_list ids)
 	{
 		assert(result.is_ready());
@@ -139,6 +181,17 @@ namespace qtor
 		m_torrent_store->erase(ids.begin(), ids.end());
 	}
 
+	bool Application::CheckTorrentsLive()
+	{
+		if (m_torrent_store->is_live()) return true;
+
+		// warm start rows carry ids of previous session, action could hit other torrent
+		auto title = tr("Torrents are not loaded yet");
+		auto message = tr("Torrents are shown from cache, actions are available once torrents are received from daemon");
+		m_notificationCenter->AddWarning(title, message);
+		return false;
+	}
+
 	void Application::Connect()
 	{
 		assert(m_source);
@@ -154,6 +207,8 @@ namespace qtor
 	void Application::StartTorrents(torrent_id_list ids)
 	{
 		assert(m_source);
+		if (not CheckTorrentsLive()) return;
+
 		ext::future<void> result = m_source->start_torrents(ids);
 
 		using std::placeholders::_1;
@@ -163,6 +218,8 @@ namespace qtor
 	void Application::StartNowTorrents(torrent_id_list ids)
 	{
 		assert(m_source);
+		if (not CheckTorrentsLive()) return;
+
 		ext::future<void> result = m_source->start_torrents_now(ids);
 
 		using std::placeholders::_1;
@@ -172,6 +229,8 @@ namespace qtor
 	void Application::StopTorrents(torrent_id_list ids)
 	{
 		assert(m_source);
+		if (not CheckTorrentsLive()) return;
+
 		ext::future<void> result = m_source->stop_torrents(ids);
 
 		using std::placeholders::_1;
@@ -181,6 +240,8 @@ namespace qtor
 	void Application::AnnounceTorrents(torrent_id_list ids)
 	{
 		assert(m_source);
+		if (not CheckTorrentsLive()) return;
+
 		ext::future<void> result = m_source->announce_torrents(ids);
 
 		using std::placeholders::_1;
@@ -190,6 +251,8 @@ namespace qtor
 	void Application::RemoveTorrents(torrent_id_list ids)
 	{
 		assert(m_source);
+		if (not CheckTorrentsLive()) return;
+
 		ext::future<void> result = m_source->remove_torrents(ids);
 
 		using std::placeholders::_1;
@@ -199,6 +262,8 @@ namespace qtor
 	void Application::PurgeTorrents(torrent_id_list ids)
 	{
 		assert(m_source);
+		if (not CheckTorrentsLive()) return;
+
 		ext::future<void> result = m_source->purge_torrents(ids);
 
 		using std::placeholders::_1;
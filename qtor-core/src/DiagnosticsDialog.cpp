@@ -0,0 +1,118 @@
+#include <qtor/DiagnosticsDialog.hqt>
+#include <QtTools/ToolsBase.hpp>
+
+#include <QtWidgets/QVBoxLayout>
+#include <QtWidgets/QHeaderView>
+#include <QtWidgets/QFileDialog>
+#include <QtWidgets/QMessageBox>
+
+namespace qtor
+{
+	enum DiagnosticsColumns
+	{
+		MetricColumn, LabelsColumn, ValueColumn, MeanColumn, P50Column, P99Column, MaxColumn, ColumnCount
+	};
+
+	void DiagnosticsDialog::Refresh()
+	{
+		using namespace metrics;
+
+		int row = 0;
+		auto set_row = [this, &row](const std::string & name, const std::string & labels, QStringList values)
+		{
+			if (row >= m_table->rowCount())
+				m_table->insertRow(row);
+
+			values.prepend(QtTools::ToQString(labels));
+			values.prepend(QtTools::ToQString(name));
+
+			for (int column = 0; column < ColumnCount; ++column)
+			{
+				auto * item = m_table->item(row, column);
+				if (not item)
+				{
+					item = new QTableWidgetItem;
+					item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+					m_table->setItem(row, column, item);
+				}
+
+				item->setText(column < values.size() ? values[column] : QString());
+			}
+
+			++row;
+		};
+
+		registry::instance().for_each([&set_row](const std::string & name, const std::string & labels, const registry::entry & entry)
+		{
+			if (auto * ptr = std::get_if<std::unique_ptr<counter>>(&entry.metric))
+				set_row(name, labels, {QString::number((*ptr)->value())});
+			else if (auto * ptr = std::get_if<std::unique_ptr<gauge>>(&entry.metric))
+				set_row(name, labels, {QString::number((*ptr)->value()), QString(), QString(), QString(), QString::number((*ptr)->max())});
+			else if (auto * ptr = std::get_if<std::unique_ptr<histogram>>(&entry.metric))
+			{
+				auto & hist = **ptr;
+				set_row(name, labels, {
+					QString::number(hist.count()),
+					QString::number(hist.mean(), 'f', 1),
+					QString::number(hist.quantile(0.5)),
+					QString::number(hist.quantile(0.99)),
+					QString::number(hist.max()),
+				});
+			}
+		});
+
+		m_table->setRowCount(row);
+	}
+
+	void DiagnosticsDialog::ExportPrometheus()
+	{
+		QString path = QFileDialog::getSaveFileName(this, tr("Export metrics"), QStringLiteral("qtor.prom"), tr("Prometheus text (*.prom *.txt)"));
+
+		if (path.isEmpty()) return;
+
+		if (not metrics::registry::instance().write_prometheus(QtTools::FromQString(path)))
+			QMessageBox::warning(this, tr("Export metrics"), tr("Failed to write %1").arg(path));
+	}
+
+	void DiagnosticsDialog::setupUi()
+	{
+		m_table = new QTableWidget(0, ColumnCount, this);
+		m_table->verticalHeader()->hide();
+		m_table->horizontalHeader()->setStretchLastSection(true);
+		m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+		m_buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+		m_exportButton = m_buttons->addButton(QString(), QDialogButtonBox::ActionRole);
+
+		auto * layout = new QVBoxLayout(this);
+		layout->addWidget(m_table);
+		layout->addWidget(m_buttons);
+
+		connect(m_buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+		connect(m_exportButton, &QPushButton::clicked, this, &DiagnosticsDialog::ExportPrometheus);
+		connect(&m_refreshTimer, &QTimer::timeout, this, &DiagnosticsDialog::Refresh);
+	}
+
+	void DiagnosticsDialog::retranslateUi()
+	{
+		setWindowTitle(tr("Diagnostics"));
+		m_exportButton->setText(tr("&Export..."));
+
+		m_table->setHorizontalHeaderLabels({
+			tr("Metric"), tr("Labels"), tr("Value/Count"), tr("Mean"), tr("p50"), tr("p99"), tr("Max"),
+		});
+	}
+
+	DiagnosticsDialog::DiagnosticsDialog(QWidget * parent /* = nullptr */)
+		: QDialog(parent)
+	{
+		setupUi();
+		retranslateUi();
+
+		Refresh();
+		m_table->resizeColumnsToContents();
+		resize(800, 400);
+
+		m_refreshTimer.start(1000);
+	}
+}
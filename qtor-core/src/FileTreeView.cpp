@@ -292,7 +292,7 @@ namespace qtor
 		m_sizeHint = m_defMinSizeHint;
 	}
 
-	void FileTreeView::SetModel(std::shared_ptr<FileTreeModel> model)
+	void FileTreeView::SetModel(std::shared_ptr<FileTreeModelBase> model)
 	{
 		// both null or valid
 		if (m_model) m_model->disconnect(this);
@@ -309,6 +309,20 @@ namespace qtor
 		}
 	}
 
+	void FileTreeView::SetFileStore(std::shared_ptr<torrent_file_store> store)
+	{
+		if (not store)
+		{
+			// model references store, release it first
+			SetModel(nullptr);
+			m_fileStore.reset();
+			return;
+		}
+
+		SetModel(std::make_shared<FileTreeViewModel>(store));
+		m_fileStore = std::move(store);
+	}
+
 	void FileTreeView::InitHeaderTracking(QtTools::HeaderSectionInfoList * headerConf /* = nullptr */)
 	{
 		m_headerConfig = headerConf;
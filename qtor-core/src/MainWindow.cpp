@@ -1,4 +1,7 @@
 #include <qtor/MainWindow.hqt>
+#include <qtor/tracing.hpp>
+#include <qtor/metrics.hpp>
+#include <qtor/DiagnosticsDialog.hqt>
 #include <QtTools/Utility.hpp>
 #include <QtTools/NotificationSystem/NotificationPopupLayout.hqt>
 
@@ -23,6 +26,67 @@ namespace qtor
 
 	}
 
+	void MainWindow::OnSessionStat(const session_stat & stat)
+	{
+		m_downloadSpeedLabel->setText(tr("Down: %1").arg(m_fmt->format_speed(stat.download_speed)));
+		m_uploadSpeedLabel->setText(tr("Up: %1").arg(m_fmt->format_speed(stat.upload_speed)));
+
+		//: %1 - active torrents, %2 - paused torrents, %3 - total torrents
+		m_torrentCountLabel->setText(tr("Active: %1, paused: %2 of %3")
+			.arg(stat.active_torrent_count)
+			.arg(stat.paused_torrent_count)
+			.arg(stat.torrent_count));
+
+		// totals are maintained incrementally by aggregator, reading them is cheap
+		if (auto aggregator = m_app->GetAggregator())
+		{
+			auto & total = aggregator->total();
+			//: %1 - total size of all torrents, %2 - downloaded, %3 - uploaded
+			m_torrentCountLabel->setToolTip(tr("Size: %1, downloaded: %2, uploaded: %3")
+				.arg(m_fmt->format_size(static_cast<size_type>(total.stats(torrent::TotalSize).sum)))
+				.arg(m_fmt->format_size(static_cast<size_type>(total.stats(torrent::EverDownloaded).sum)))
+				.arg(m_fmt->format_size(static_cast<size_type>(total.stats(torrent::EverUploaded).sum))));
+
+			// selection aggregate follows store updates, refresh summary at session stat pace
+			m_detailView->SetTorrents(aggregator->selection());
+		}
+
+		if (stat.free_space)
+		{
+			m_freeSpaceLabel->setText(tr("Free space: %1").arg(m_fmt->format_size(*stat.free_space)));
+			m_freeSpaceLabel->setToolTip(stat.download_dir);
+		}
+	}
+
+	void MainWindow::OnTorrentSelectionChanged(torrent_id_list ids)
+	{
+		auto aggregator = m_app->GetAggregator();
+		aggregator->set_selection(ids);
+		m_detailView->SetTorrents(aggregator->selection());
+
+		// details are polled only for single selected torrent, views hold stores and keep them subscribed while shown
+		if (ids.size() != 1)
+		{
+			m_detailView->SetDetailStore(nullptr);
+			m_detailView->SetPeerStore(nullptr);
+			m_fileView->SetFileStore(nullptr);
+			return;
+		}
+
+		auto id = ids.front();
+		auto detailStore = m_detailView->GetDetailStore();
+		if (not detailStore or detailStore->torrent_id() != id)
+			m_detailView->SetDetailStore(m_app->AccquireTorrentDetailStore(id));
+
+		auto peerStore = m_detailView->GetPeerStore();
+		if (not peerStore or peerStore->torrent_id() != id)
+			m_detailView->SetPeerStore(m_app->AccquireTorrentPeerStore(id));
+
+		auto fileStore = m_fileView->GetFileStore();
+		if (not fileStore or fileStore->torrent_id() != id)
+			m_fileView->SetFileStore(m_app->AccquireTorrentFileStore(id));
+	}
+
 	void MainWindow::Connect()
 	{
 		m_app->Connect();
@@ -40,6 +104,7 @@ namespace qtor
 		connect(m_app, &Application::Connected, this, &MainWindow::OnConnected);
 		connect(m_app, &Application::Disconnected, this, &MainWindow::OnDisconnected);
 		connect(m_app, &Application::ConnectionError, this, &MainWindow::OnConnectionError);
+		connect(m_app, &Application::SessionStatUpdated, this, &MainWindow::OnSessionStat);
 
 
 		connect(m_torrentWidget, &TorrentsView::StartTorrents, m_app, &Application::StartTorrents);
@@ -48,6 +113,7 @@ namespace qtor
 		connect(m_torrentWidget, &TorrentsView::AnnounceTorrents, m_app, &Application::AnnounceTorrents);
 		connect(m_torrentWidget, &TorrentsView::RemoveTorrents, m_app, &Application::RemoveTorrents);
 		connect(m_torrentWidget, &TorrentsView::PurgeTorrents, m_app, &Application::PurgeTorrents);
+		connect(m_torrentWidget, &TorrentsView::SelectionChanged, this, &MainWindow::OnTorrentSelectionChanged);
 
 
 		//connect(m_actionStopAll, &QAction::triggered, this, [this](bool) { m_app->StopTorrents({}); });
@@ -80,6 +146,16 @@ namespace qtor
 
 	}
 
+	void MainWindow::paintEvent(QPaintEvent * ev)
+	{
+		QMainWindow::paintEvent(ev);
+		if (not m_firstPaint) return;
+
+		// torrent list is painted in same frame, with warm start snapshot it already has torrents
+		m_firstPaint = false;
+		metrics::pipeline().startup_first_paint_ms.set(tracing::now() / 1000000);
+	}
+
 	void MainWindow::setupToolBars()
 	{
 		m_actionOpen = new QAction(this);
@@ -107,6 +183,16 @@ namespace qtor
 		m_statusbar = new QStatusBar(this);
 		m_statusBarLabel = new QLabel(this);
 		m_statusbar->addWidget(m_statusBarLabel);
+
+		m_downloadSpeedLabel = new QLabel(this);
+		m_uploadSpeedLabel = new QLabel(this);
+		m_torrentCountLabel = new QLabel(this);
+		m_freeSpaceLabel = new QLabel(this);
+
+		m_statusbar->addPermanentWidget(m_torrentCountLabel);
+		m_statusbar->addPermanentWidget(m_freeSpaceLabel);
+		m_statusbar->addPermanentWidget(m_downloadSpeedLabel);
+		m_statusbar->addPermanentWidget(m_uploadSpeedLabel);
 		setStatusBar(m_statusbar);
 
 
@@ -123,6 +209,16 @@ namespace qtor
 	{
 		m_torrentWidget = new TorrentsView(this);
 		setCentralWidget(m_torrentWidget);
+
+		m_detailDock = new QDockWidget(this);
+		m_detailDock->setObjectName("detail_dock");
+		m_detailTabs = new QTabWidget(m_detailDock);
+		m_detailView = new TorrentDetailView(m_detailTabs);
+		m_fileView = new FileTreeView(m_detailTabs);
+		m_detailTabs->addTab(m_detailView, QString());
+		m_detailTabs->addTab(m_fileView, QString());
+		m_detailDock->setWidget(m_detailTabs);
+		addDockWidget(Qt::BottomDockWidgetArea, m_detailDock);
 	}
 
 	void MainWindow::setupMenu()
@@ -133,11 +229,26 @@ namespace qtor
 		main->addAction(m_actionStopAll);
 		main->addAction(m_actionDelete);
 		main->addAction(m_actionPreferences);
+
+		m_actionRecordTrace = new QAction(this);
+		m_actionRecordTrace->setCheckable(true);
+		m_actionRecordTrace->setChecked(tracing::enabled());
+		m_actionSaveTrace = new QAction(this);
+		m_actionMetrics = new QAction(this);
+
+		QMenu * diagnostics = menuBar()->addMenu(tr("&Diagnostics"));
+		diagnostics->addAction(m_actionMetrics);
+		diagnostics->addSeparator();
+		diagnostics->addAction(m_actionRecordTrace);
+		diagnostics->addAction(m_actionSaveTrace);
 	}
 
 	void MainWindow::connectSignals()
 	{
 		connect(m_actionOpen, &QAction::triggered, this, &MainWindow::saveToSvg);
+		connect(m_actionRecordTrace, &QAction::toggled, this, [](bool checked) { tracing::enable(checked); });
+		connect(m_actionSaveTrace, &QAction::triggered, this, &MainWindow::saveTrace);
+		connect(m_actionMetrics, &QAction::triggered, this, &MainWindow::showMetrics);
 	}
 
 	void MainWindow::saveToSvg()
@@ -156,9 +267,31 @@ namespace qtor
 
 	}
 
-	void MainWindow::retranslateUi()
+	void MainWindow::saveTrace()
+	{
+		QString path = QFileDialog::getSaveFileName(this, tr("Save trace"), QStringLiteral("trace.json"), tr("Chrome trace (*.json)"));
+
+		if (path.isEmpty()) return;
+
+		if (not tracing::write_chrome_trace(QtTools::FromQString(path)))
+			QMessageBox::warning(this, tr("Save trace"), tr("Failed to write %1").arg(path));
+	}
+
+	void MainWindow::showMetrics()
 	{
+		auto * dialog = new DiagnosticsDialog(this);
+		dialog->setAttribute(Qt::WA_DeleteOnClose);
+		dialog->show();
+	}
 
+	void MainWindow::retranslateUi()
+	{
+		m_detailDock->setWindowTitle(tr("Details"));
+		m_detailTabs->setTabText(m_detailTabs->indexOf(m_detailView), tr("&General"));
+		m_detailTabs->setTabText(m_detailTabs->indexOf(m_fileView), tr("&Files"));
+		m_actionMetrics->setText(tr("&Metrics..."));
+		m_actionRecordTrace->setText(tr("&Record trace"));
+		m_actionSaveTrace->setText(tr("&Save trace..."));
 	}
 
 	void MainWindow::retranslateToolBars()
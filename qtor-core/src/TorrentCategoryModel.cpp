@@ -8,13 +8,13 @@ namespace qtor
 	{
 		switch (cat)
 		{
-			case category_type::all:             return tr("all");
-			case category_type::downloading:     return tr("downloading");
-			case category_type::downloaded:      return tr("downloaded");
-			case category_type::active:          return tr("active");
-			case category_type::nonactive:       return tr("nonactive");
-			case category_type::stopped:         return tr("stopped");
-			case category_type::error:           return tr("error");
+			case torrent_category::all:             return tr("all");
+			case torrent_category::downloading:     return tr("downloading");
+			case torrent_category::downloaded:      return tr("downloaded");
+			case torrent_category::active:          return tr("active");
+			case torrent_category::nonactive:       return tr("nonactive");
+			case torrent_category::stopped:         return tr("stopped");
+			case torrent_category::error:           return tr("error");
 			default:                             return tr("Unknown category");
 		}
 	}
@@ -23,53 +23,31 @@ namespace qtor
 	{
 		switch (cat)
 		{
-			case category_type::all:             return QIcon::fromTheme("");
-			case category_type::downloading:     return QIcon::fromTheme("");
-			case category_type::downloaded:      return QIcon::fromTheme("");
-			case category_type::active:          return QIcon::fromTheme("");
-			case category_type::nonactive:       return QIcon::fromTheme("");
-			case category_type::stopped:         return QIcon::fromTheme("");
-			case category_type::error:           return QIcon::fromTheme("");
+			case torrent_category::all:             return QIcon::fromTheme("");
+			case torrent_category::downloading:     return QIcon::fromTheme("");
+			case torrent_category::downloaded:      return QIcon::fromTheme("");
+			case torrent_category::active:          return QIcon::fromTheme("");
+			case torrent_category::nonactive:       return QIcon::fromTheme("");
+			case torrent_category::stopped:         return QIcon::fromTheme("");
+			case torrent_category::error:           return QIcon::fromTheme("");
 			default:                             return {};
 		}
 	}
 
 	auto TorrentCategoryModel::Category(const torrent & torr) noexcept -> category_set
 	{
-		category_set result;
-		const auto status = torr.status();
-		const auto requested_size = torr.requested_size();
-		const auto current_size = torr.current_size();
-		const auto error_string = torr.error_string();
-
-		const bool all = true;
-		const bool error = error_string.has_value();
-		const bool stopped = status == torrent_status::stopped;
-		const bool active = not stopped and not error;
-		const bool nonactive = not stopped;
-		const bool downloading = status == torrent_status::downloading or status == torrent_status::downloading_queued;
-		const bool downloaded = current_size == requested_size;
-
-		result.set(category_type::all, all);
-		result.set(category_type::error, error);
-		result.set(category_type::stopped, stopped);
-		result.set(category_type::active, active);
-		result.set(category_type::nonactive, nonactive);
-		result.set(category_type::downloading, downloading);
-		result.set(category_type::downloaded, downloaded);
-
-		return result;
+		return torrent_categories(torr);
 	}
 
 	void TorrentCategoryModel::InitCategoryItems()
 	{
-		m_categories.push_back({.category = all});
-		m_categories.push_back({.category = downloading});
-		m_categories.push_back({.category = downloaded});
-		m_categories.push_back({.category = active});
-		m_categories.push_back({.category = nonactive});
-		m_categories.push_back({.category = stopped});
-		m_categories.push_back({.category = error});
+		m_categories.push_back({.category = torrent_category::all});
+		m_categories.push_back({.category = torrent_category::downloading});
+		m_categories.push_back({.category = torrent_category::downloaded});
+		m_categories.push_back({.category = torrent_category::active});
+		m_categories.push_back({.category = torrent_category::nonactive});
+		m_categories.push_back({.category = torrent_category::stopped});
+		m_categories.push_back({.category = torrent_category::error});
 
 		for (auto & cat : m_categories)
 		{
@@ -92,22 +70,114 @@ namespace qtor
 		for (auto & category_item : m_categories)
 			category_item.count =  0;
 
+		m_torrent_categories.clear();
 		if (m_torrent_store)
 		{
+			std::vector<std::size_t> unused;
 			for (const torrent & tor : *m_torrent_store)
 			{
 				auto catset = Category(tor);
+				m_torrent_categories.emplace(&tor, catset);
+				AddCategories(catset, unused, +1);
+			}
+		}
+
+		int first = 0;
+		int last  = qint(m_categories.size() - 1);
+		Q_EMIT dataChanged(index(first), index(last));
+	}
+
+	void TorrentCategoryModel::AddCategories(category_set catset, std::vector<std::size_t> & old_counts, int sign)
+	{
+		for (int cat = 0; cat < torrent_category::count; ++cat)
+		{
+			if (not catset[static_cast<category_type>(cat)]) continue;
+
+			// first touch of category in this update - remember count it had before
+			if (old_counts.size() > static_cast<std::size_t>(cat) and old_counts[cat] == std::size_t(-1))
+				old_counts[cat] = m_categories[cat].count;
+
+			m_categories[cat].count += sign;
+		}
+	}
+
+	void TorrentCategoryModel::EmitChangedCounts(const std::vector<std::size_t> & old_counts)
+	{
+		for (int cat = 0; cat < torrent_category::count; ++cat)
+		{
+			auto old_count = old_counts[cat];
+			if (old_count != std::size_t(-1) and old_count != m_categories[cat].count)
+				Q_EMIT dataChanged(index(cat), index(cat));
+		}
+	}
+
+	template <class Range>
+	void TorrentCategoryModel::OnUpdate(const Range & erased, const Range & updated, const Range & inserted)
+	{
+		std::vector<std::size_t> old_counts(torrent_category::count, std::size_t(-1));
 
-				if (catset[all])         m_categories[0].count += 1;
-				if (catset[downloading]) m_categories[1].count += 1;
-				if (catset[downloaded])  m_categories[2].count += 1;
-				if (catset[active])      m_categories[3].count += 1;
-				if (catset[nonactive])   m_categories[4].count += 1;
-				if (catset[stopped])     m_categories[5].count += 1;
-				if (catset[error])       m_categories[6].count += 1;
+		for (const torrent * ptr : erased)
+		{
+			auto it = m_torrent_categories.find(ptr);
+			if (it == m_torrent_categories.end()) continue;
+
+			AddCategories(it->second, old_counts, -1);
+			m_torrent_categories.erase(it);
+		}
+
+		for (const torrent * ptr : updated)
+		{
+			auto it = m_torrent_categories.find(ptr);
+			if (it == m_torrent_categories.end())
+			{
+				auto catset = Category(*ptr);
+				m_torrent_categories.emplace(ptr, catset);
+				AddCategories(catset, old_counts, +1);
+				continue;
 			}
+
+			if (not (m_torrent_store->last_changed_fields(ptr->id()) & torrent_category_fields))
+				continue;
+
+			auto catset = Category(*ptr);
+			AddCategories(it->second, old_counts, -1);
+			AddCategories(catset, old_counts, +1);
+			it->second = catset;
+		}
+
+		for (const torrent * ptr : inserted)
+		{
+			auto catset = Category(*ptr);
+			m_torrent_categories.insert_or_assign(ptr, catset);
+			AddCategories(catset, old_counts, +1);
+		}
+
+		EmitChangedCounts(old_counts);
+	}
+
+	template <class Range>
+	void TorrentCategoryModel::OnErase(const Range & erased)
+	{
+		std::vector<std::size_t> old_counts(torrent_category::count, std::size_t(-1));
+
+		for (const torrent * ptr : erased)
+		{
+			auto it = m_torrent_categories.find(ptr);
+			if (it == m_torrent_categories.end()) continue;
+
+			AddCategories(it->second, old_counts, -1);
+			m_torrent_categories.erase(it);
 		}
 
+		EmitChangedCounts(old_counts);
+	}
+
+	void TorrentCategoryModel::OnClear()
+	{
+		m_torrent_categories.clear();
+		for (auto & category_item : m_categories)
+			category_item.count = 0;
+
 		int first = 0;
 		int last  = qint(m_categories.size() - 1);
 		Q_EMIT dataChanged(index(first), index(last));
@@ -119,10 +189,9 @@ namespace qtor
 		{
 			m_torrent_store = std::move(store);
 
-			auto callback = [this](auto && ...) { RecalculateData(); };
-			m_on_update_conn = m_torrent_store->on_update(callback);
-			m_on_erase_conn = m_torrent_store->on_erase(callback);
-			m_on_clear_conn = m_torrent_store->on_clear(callback);
+			m_on_update_conn = m_torrent_store->on_update([this](const auto & erased, const auto & updated, const auto & inserted) { OnUpdate(erased, updated, inserted); });
+			m_on_erase_conn = m_torrent_store->on_erase([this](const auto & erased) { OnErase(erased); });
+			m_on_clear_conn = m_torrent_store->on_clear([this] { OnClear(); });
 		}
 		else
 		{
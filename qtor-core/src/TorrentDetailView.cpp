@@ -3,12 +3,29 @@
 
 namespace qtor
 {
+	void TorrentDetailView::SetTorrents(const torrent_aggregate & aggregate)
+	{
+		auto size = [&aggregate](auto field) { return static_cast<size_type>(aggregate.stats(field).sum); };
+
+		auto total = size(torrent::TotalSize);
+		auto requested = size(torrent::RequestedSize);
+		auto current = size(torrent::CurrentSize);
+
+		m_sizeValueLabel->setText(m_fmt->format_size(total));
+		m_haveValueLabel->setText(tr("%1 of %2 (%3)")
+			.arg(m_fmt->format_size(current))
+			.arg(m_fmt->format_size(requested))
+			.arg(m_fmt->format_percent(requested ? double(current) / requested : 0.0)));
+
+		m_downloadedValueLabel->setText(m_fmt->format_size(size(torrent::EverDownloaded)));
+		m_uploadedValueLabel->setText(m_fmt->format_size(size(torrent::EverUploaded)));
+	}
+
 	void TorrentDetailView::SetTorrent(const torrent_list & torrents)
 	{
 		uint64_type status;
 		bool paused;
 
-		size_type have_total = 0;
 		size_type have_verified = 0;
 		size_type have_unverified = 0;
 		size_type verified_peices = 0;
@@ -25,7 +42,6 @@ namespace qtor
 				const bool error = status == torrent_status::unknown or not error_string.isEmpty();
 			}
 
-			have_total += torr.total_size().value_or(0);
 			//have_verified += torr.
 
 			QString str;
@@ -99,6 +115,56 @@ namespace qtor
 
 	}
 
+	void TorrentDetailView::OnDetailUpdate(const torrent_detail & detail)
+	{
+		m_trackersValueLabel->setText(QString::number(detail.trackers.size()));
+
+		// peer store, if attached, is updated more often
+		if (not m_peerStore)
+			m_peersValueLabel->setText(QString::number(detail.peers.size()));
+	}
+
+	void TorrentDetailView::OnPeersChanged()
+	{
+		m_peersValueLabel->setText(QString::number(m_peerStore->size()));
+	}
+
+	void TorrentDetailView::SetDetailStore(std::shared_ptr<torrent_detail_store> store)
+	{
+		m_detailUpdateConnection.disconnect();
+		m_detailStore = std::move(store);
+
+		if (not m_detailStore)
+		{
+			QString valuePlaceholder = tr("...");
+			m_trackersValueLabel->setText(valuePlaceholder);
+			if (not m_peerStore) m_peersValueLabel->setText(valuePlaceholder);
+			return;
+		}
+
+		m_detailUpdateConnection = m_detailStore->on_update([this](const torrent_detail & detail) { OnDetailUpdate(detail); });
+		OnDetailUpdate(m_detailStore->detail());
+	}
+
+	void TorrentDetailView::SetPeerStore(std::shared_ptr<torrent_peer_store> store)
+	{
+		m_peerUpdateConnection.disconnect();
+		m_peerEraseConnection.disconnect();
+		m_peerClearConnection.disconnect();
+		m_peerStore = std::move(store);
+
+		if (not m_peerStore)
+		{
+			m_peersValueLabel->setText(m_detailStore ? QString::number(m_detailStore->detail().peers.size()) : tr("..."));
+			return;
+		}
+
+		m_peerUpdateConnection = m_peerStore->on_update([this](const auto &, const auto &, const auto &) { OnPeersChanged(); });
+		m_peerEraseConnection = m_peerStore->on_erase([this](const auto &) { OnPeersChanged(); });
+		m_peerClearConnection = m_peerStore->on_clear([this] { OnPeersChanged(); });
+		OnPeersChanged();
+	}
+
 	TorrentDetailView::TorrentDetailView(QWidget * parent)
 	    : QFrame(parent)
 	{
@@ -156,6 +222,8 @@ namespace qtor
 		init(m_hashLabel, m_hashValueLabel);
 		init(m_privacyLabel, m_privacyValueLabel);
 		init(m_originLabel, m_originValueLabel);
+		init(m_trackersLabel, m_trackersValueLabel);
+		init(m_peersLabel, m_peersValueLabel);
 
 #undef init
 #undef init3
@@ -221,6 +289,8 @@ namespace qtor
 		m_hashLabel->setText(tr("Hash:"));
 		m_privacyLabel->setText(tr("Privacy:"));
 		m_originLabel->setText(tr("Origin:"));
+		m_trackersLabel->setText(tr("Trackers:"));
+		m_peersLabel->setText(tr("Peers:"));
 		m_commentLabel->setText(tr("Comment:"));
 	}
 }
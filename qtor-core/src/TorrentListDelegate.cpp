@@ -1,5 +1,6 @@
 ﻿#include <qtor/TorrentListDelegate.hqt>
 #include <qtor/TorrentsModel.hpp>
+#include <qtor/tracing.hpp>
 
 #include <QtCore/QStringBuilder>
 #include <QtGui/QPainter>
@@ -472,6 +473,7 @@ namespace qtor
 
 	void TorrentListDelegate::paint(QPainter * painter, const QStyleOptionViewItem & option, const QModelIndex & index) const
 	{
+		QTOR_TRACE_SCOPE("TorrentListDelegate::paint");
 		LayoutItem(option, index, m_cachedItem);
 
 		painter->save();
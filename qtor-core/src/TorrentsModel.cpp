@@ -1,5 +1,9 @@
 ﻿#include <qtor/TorrentsModel.hpp>
+#include <qtor/tracing.hpp>
+#include <qtor/metrics.hpp>
 #include <QtTools/ToolsBase.hpp>
+#include <unordered_set>
+#include <boost/range/empty.hpp>
 
 namespace qtor
 {
@@ -49,14 +53,63 @@ namespace qtor
 
 	void TorrentsModel::FilterBy(QString expr)
 	{
+		QTOR_TRACE_SCOPE("TorrentsModel::FilterBy");
+		metrics::scoped_timer timer(metrics::pipeline().filter_us);
 		filter_by(expr);
 	}
 
 	void TorrentsModel::SortBy(int column, Qt::SortOrder order)
 	{
+		QTOR_TRACE_SCOPE("TorrentsModel::SortBy");
+		metrics::scoped_timer timer(metrics::pipeline().sort_us);
 		return sort_by(m_columns[column], order == Qt::AscendingOrder);
 	}
 
+	void TorrentsModel::update_data(const signal_range_type & sorted_erased, const signal_range_type & updated, const signal_range_type & inserted)
+	{
+		field_mask view_fields = field_bit(m_sort_pred.key());
+		if (m_filter_pred)
+		{
+			for (auto key : m_filter_pred.items())
+				view_fields |= field_bit(key);
+		}
+
+		bool same_rows = boost::empty(sorted_erased) and boost::empty(inserted);
+		if (same_rows and not (m_owner->last_changed_fields() & view_fields))
+			return EmitChangedCells(updated);
+
+		return view_type::update_data(sorted_erased, updated, inserted);
+	}
+
+	void TorrentsModel::EmitChangedCells(const signal_range_type & updated)
+	{
+		QTOR_TRACE_SCOPE("TorrentsModel::EmitChangedCells");
+
+		std::unordered_set<const torrent *> changed;
+		for (const torrent * ptr : updated)
+		{
+			if (m_owner->last_changed_fields(ptr->id()))
+				changed.insert(ptr);
+		}
+
+		if (changed.empty()) return;
+
+		// whole rows are invalidated: list mode delegate paints row from all fields, while QListView shows only one model column
+		// and ignores dataChanged not covering it. Adjacent changed rows are joined into one signal
+		int last_column = qint(m_columns.size()) - 1;
+		int rows = qint(m_store.size());
+		for (int row = 0; row < rows; ++row)
+		{
+			if (not changed.count(m_store[row])) continue;
+
+			int first = row;
+			while (row + 1 < rows and changed.count(m_store[row + 1]))
+				++row;
+
+			Q_EMIT dataChanged(index(first, 0), index(row, last_column));
+		}
+	}
+
 	TorrentsModel::TorrentsModel(std::shared_ptr<torrent_store> store, QObject * parent)
 		: base_type(parent), view_type(std::move(store))
 	{
@@ -37,6 +37,30 @@ namespace qtor
 		}
 	}
 
+	void TorrentsView::OnSelectionChanged()
+	{
+		Q_EMIT SelectionChanged(GetSelectedTorrents());
+	}
+
+	auto TorrentsView::GetSelectedTorrents() const -> torrent_id_list
+	{
+		torrent_id_list ids;
+		if (not m_model) return ids;
+
+		QModelIndexList selected = m_itemView == m_tableView
+			? m_tableView->selectionModel()->selectedRows()
+			: m_listView->selectionModel()->selectedIndexes();
+
+		ids.reserve(selected.size());
+		for (const QModelIndex & idx : selected)
+		{
+			auto * torrent_ptr = qvariant_cast<const torrent *>(m_model->GetEntity(idx));
+			if (torrent_ptr) ids.push_back(torrent_ptr->id());
+		}
+
+		return ids;
+	}
+
 	void TorrentsView::Sort(int column, Qt::SortOrder order)
 	{
 		if (not m_model) return;
@@ -376,6 +400,9 @@ namespace qtor
 
 		setFocusProxy(m_itemView);
 		QWidget::setTabOrder(m_rowFilter, m_itemView);
+
+		// views keep own selections
+		if (m_model) OnSelectionChanged();
 	}
 
 	void TorrentsView::ConnectModel()
@@ -395,6 +422,10 @@ namespace qtor
 		connect(m_tableView->horizontalHeader(), &QHeaderView::customContextMenuRequested,
 		        this, &TorrentsView::OpenHeaderConfigurationWidget);
 
+		// selection models are recreated by setModel
+		connect(m_tableView->selectionModel(), &QItemSelectionModel::selectionChanged, this, &TorrentsView::OnSelectionChanged);
+		connect(m_listView->selectionModel(), &QItemSelectionModel::selectionChanged, this, &TorrentsView::OnSelectionChanged);
+
 		if (m_sortColumn >= 0) m_model->sort(m_sortColumn, m_sortOrder);
 		m_sortMenu = CreateSortMenu();
 	}
@@ -0,0 +1,289 @@
+#include <qtor/metrics.hpp>
+#include <qtor/tracing.hpp>
+
+#include <fstream>
+#include <fmt/format.h>
+
+namespace qtor::metrics
+{
+	template <class Type>
+	static void atomic_max(std::atomic<Type> & target, Type value) noexcept
+	{
+		auto current = target.load(std::memory_order_relaxed);
+		while (current < value and not target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+			continue;
+	}
+
+	/// index of highest set bit, value must not be 0
+	static unsigned highest_bit(std::uint64_t value) noexcept
+	{
+		unsigned result = 0;
+		for (unsigned shift = 32; shift; shift /= 2)
+		{
+			if (value >> shift)
+			{
+				value >>= shift;
+				result += shift;
+			}
+		}
+
+		return result;
+	}
+
+	/************************************************************************/
+	/*                       gauge                                          */
+	/************************************************************************/
+	void gauge::add(std::int64_t delta) noexcept
+	{
+		auto value = m_value.fetch_add(delta, std::memory_order_relaxed) + delta;
+		atomic_max(m_max, value);
+	}
+
+	void gauge::set(std::int64_t value) noexcept
+	{
+		m_value.store(value, std::memory_order_relaxed);
+		atomic_max(m_max, value);
+	}
+
+	/************************************************************************/
+	/*                       histogram                                      */
+	/************************************************************************/
+	auto histogram::bucket_index(std::uint64_t value) noexcept -> unsigned
+	{
+		if (value < sub_bucket_count) return static_cast<unsigned>(value);
+
+		auto exponent = highest_bit(value);
+		auto shift = exponent - sub_bucket_bits;
+		auto sub_bucket = static_cast<unsigned>(value >> shift) & (sub_bucket_count - 1);
+		return (shift + 1) * sub_bucket_count + sub_bucket;
+	}
+
+	auto histogram::bucket_lower(unsigned idx) noexcept -> std::uint64_t
+	{
+		if (idx < sub_bucket_count) return idx;
+
+		auto shift = idx / sub_bucket_count - 1;
+		auto sub_bucket = idx % sub_bucket_count;
+		return static_cast<std::uint64_t>(sub_bucket_count + sub_bucket) << shift;
+	}
+
+	auto histogram::bucket_upper(unsigned idx) noexcept -> std::uint64_t
+	{
+		if (idx < sub_bucket_count) return idx;
+
+		auto shift = idx / sub_bucket_count - 1;
+		return bucket_lower(idx) + ((std::uint64_t(1) << shift) - 1);
+	}
+
+	void histogram::record(std::uint64_t value) noexcept
+	{
+		m_buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+		m_count.fetch_add(1, std::memory_order_relaxed);
+		m_sum.fetch_add(value, std::memory_order_relaxed);
+		atomic_max(m_max, value);
+	}
+
+	double histogram::mean() const noexcept
+	{
+		auto n = count();
+		return n ? static_cast<double>(sum()) / n : 0.0;
+	}
+
+	auto histogram::quantile(double q) const noexcept -> std::uint64_t
+	{
+		// buckets are read one by one while other threads may record, use bucket sum as total
+		std::uint64_t total = 0;
+		for (auto & bucket : m_buckets)
+			total += bucket.load(std::memory_order_relaxed);
+
+		if (total == 0) return 0;
+
+		auto rank = static_cast<std::uint64_t>(q * total);
+		if (rank >= total) rank = total - 1;
+
+		std::uint64_t seen = 0;
+		for (unsigned idx = 0; idx < bucket_count; ++idx)
+		{
+			seen += bucket(idx);
+			if (seen > rank) return std::min(bucket_upper(idx), max());
+		}
+
+		return max();
+	}
+
+	/************************************************************************/
+	/*                       scoped_timer                                   */
+	/************************************************************************/
+	scoped_timer::scoped_timer(histogram & hist) noexcept
+		: m_histogram(hist), m_start(tracing::now())
+	{
+
+	}
+
+	scoped_timer::~scoped_timer() noexcept
+	{
+		m_histogram.record(static_cast<std::uint64_t>(tracing::now() - m_start) / 1000);
+	}
+
+	/************************************************************************/
+	/*                       registry                                       */
+	/************************************************************************/
+	template <class Metric>
+	Metric & registry::get(std::string_view name, std::string_view labels, std::string_view help)
+	{
+		std::lock_guard lk(m_mutex);
+		auto [it, inserted] = m_entries.try_emplace({std::string(name), std::string(labels)});
+
+		auto & entry = it->second;
+		if (inserted)
+		{
+			entry.help = help;
+			entry.metric = std::make_unique<Metric>();
+		}
+
+		auto * ptr = std::get_if<std::unique_ptr<Metric>>(&entry.metric);
+		if (not ptr)
+			throw std::logic_error(fmt::format("metrics::registry: {} already registered with different type", name));
+
+		return **ptr;
+	}
+
+	counter & registry::get_counter(std::string_view name, std::string_view help, std::string_view labels)
+	{
+		return get<counter>(name, labels, help);
+	}
+
+	gauge & registry::get_gauge(std::string_view name, std::string_view help, std::string_view labels)
+	{
+		return get<gauge>(name, labels, help);
+	}
+
+	histogram & registry::get_histogram(std::string_view name, std::string_view help, std::string_view labels)
+	{
+		return get<histogram>(name, labels, help);
+	}
+
+	static auto labels_str(const std::string & labels, std::string_view extra = {}) -> std::string
+	{
+		if (labels.empty() and extra.empty()) return {};
+		if (labels.empty()) return fmt::format("{{{}}}", extra);
+		if (extra.empty())  return fmt::format("{{{}}}", labels);
+		return fmt::format("{{{},{}}}", labels, extra);
+	}
+
+	std::string registry::to_prometheus() const
+	{
+		std::string out;
+		auto inserter = std::back_inserter(out);
+		const std::string * family = nullptr;
+
+		auto write_header = [&](const std::string & name, const entry & entry, std::string_view type)
+		{
+			if (family and *family == name) return;
+
+			family = &name;
+			fmt::format_to(inserter, "# HELP {} {}\n", name, entry.help);
+			fmt::format_to(inserter, "# TYPE {} {}\n", name, type);
+		};
+
+		for_each([&](const std::string & name, const std::string & labels, const entry & entry)
+		{
+			if (auto * ptr = std::get_if<std::unique_ptr<counter>>(&entry.metric))
+			{
+				write_header(name, entry, "counter");
+				fmt::format_to(inserter, "{}{} {}\n", name, labels_str(labels), (*ptr)->value());
+			}
+			else if (auto * ptr = std::get_if<std::unique_ptr<gauge>>(&entry.metric))
+			{
+				write_header(name, entry, "gauge");
+				fmt::format_to(inserter, "{}{} {}\n", name, labels_str(labels), (*ptr)->value());
+			}
+			else if (auto * ptr = std::get_if<std::unique_ptr<histogram>>(&entry.metric))
+			{
+				auto & hist = **ptr;
+				write_header(name, entry, "histogram");
+
+				// only non empty buckets are written, cumulative counts stay correct
+				std::uint64_t cumulative = 0;
+				for (unsigned idx = 0; idx < histogram::bucket_count; ++idx)
+				{
+					auto n = hist.bucket(idx);
+					if (not n) continue;
+
+					cumulative += n;
+					auto le = fmt::format("le=\"{}\"", histogram::bucket_upper(idx));
+					fmt::format_to(inserter, "{}_bucket{} {}\n", name, labels_str(labels, le), cumulative);
+				}
+
+				fmt::format_to(inserter, "{}_bucket{} {}\n", name, labels_str(labels, "le=\"+Inf\""), cumulative);
+				fmt::format_to(inserter, "{}_sum{} {}\n", name, labels_str(labels), hist.sum());
+				fmt::format_to(inserter, "{}_count{} {}\n", name, labels_str(labels), cumulative);
+			}
+		});
+
+		return out;
+	}
+
+	bool registry::write_prometheus(const std::string & path) const
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << to_prometheus();
+		return static_cast<bool>(file.flush());
+	}
+
+	registry & registry::instance()
+	{
+		static registry instance;
+		return instance;
+	}
+
+	/************************************************************************/
+	/*                       well known metrics                             */
+	/************************************************************************/
+	rpc_metrics & rpc(std::string_view method)
+	{
+		static std::mutex mutex;
+		static std::map<std::string, std::unique_ptr<rpc_metrics>, std::less<>> methods;
+
+		std::lock_guard lk(mutex);
+		auto it = methods.find(method);
+		if (it != methods.end()) return *it->second;
+
+		auto & reg = registry::instance();
+		auto labels = fmt::format("method=\"{}\"", method);
+
+		auto metrics = std::unique_ptr<rpc_metrics>(new rpc_metrics {
+			reg.get_counter("qtor_rpc_requests_total", "Number of rpc requests sent", labels),
+			reg.get_counter("qtor_rpc_request_bytes_total", "Bytes of rpc request bodies sent", labels),
+			reg.get_counter("qtor_rpc_response_bytes_total", "Bytes of rpc response bodies received", labels),
+			reg.get_histogram("qtor_rpc_latency_microseconds", "Rpc round trip time, microseconds", labels),
+		});
+
+		return *methods.emplace(std::string(method), std::move(metrics)).first->second;
+	}
+
+	pipeline_metrics & pipeline()
+	{
+		static pipeline_metrics metrics = []
+		{
+			auto & reg = registry::instance();
+			return pipeline_metrics {
+				reg.get_histogram("qtor_parse_nanoseconds_per_torrent", "parse_torrent_list time per torrent, nanoseconds"),
+				reg.get_histogram("qtor_upsert_batch_size", "Records per torrent_store upsert or assign"),
+				reg.get_counter("qtor_upsert_unchanged_total", "Upserted records skipped because no field changed"),
+				reg.get_histogram("qtor_model_sort_microseconds", "TorrentsModel resort time, microseconds"),
+				reg.get_histogram("qtor_model_filter_microseconds", "TorrentsModel refilter time, microseconds"),
+				reg.get_gauge("qtor_gui_queue_depth", "Snapshots posted to gui executor and not yet processed"),
+				reg.get_counter("qtor_snapshots_coalesced_total", "Snapshots merged into already pending emission"),
+				reg.get_counter("qtor_snapshots_dropped_total", "Snapshots discarded because subscription was not opened"),
+				reg.get_gauge("qtor_startup_first_paint_milliseconds", "Time from start to first main window paint, milliseconds"),
+				reg.get_gauge("qtor_startup_first_live_milliseconds", "Time from start to first live torrents snapshot, milliseconds"),
+				reg.get_gauge("qtor_startup_snapshot_torrents", "Torrents loaded from warm start snapshot"),
+				reg.get_gauge("qtor_string_pool_strings", "Strings in string pools"),
+				reg.get_gauge("qtor_string_pool_shared_bytes", "Bytes saved by pooled strings sharing buffers, as of last pool collect"),
+			};
+		}();
+
+		return metrics;
+	}
+}
@@ -0,0 +1,577 @@
+#include <qtor/multi_data_source.hpp>
+#include <qtor/metrics.hpp>
+#include <QtTools/gui_executor.hqt>
+#include <QtTools/ToolsBase.hpp>
+
+#include <mutex>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+
+namespace qtor
+{
+	/// Subscribes to every child and merges their latest data.
+	/// Children deliver data on their own threads, only latest part of each child is kept,
+	/// and at most one merge task is pending in gui executor at any time.
+	/// Merged data is kept between emissions, only parts of children which delivered new data since previous one are patched in.
+	template <class Data>
+	class multi_data_source::merged_subscription : public ext::net::abstract_subscription_controller
+	{
+		friend multi_data_source;
+
+	public:
+		using handler_type = std::function<void (Data & data)>;
+		/// patches merged with parts marked dirty, merge function may move from them
+		using merge_function = void (*)(Data & merged, std::vector<std::optional<Data>> & parts, const std::vector<bool> & dirty);
+
+	protected:
+		multi_data_source * m_owner;
+		handler_type m_handler;
+		merge_function m_merge;
+
+		std::mutex m_data_mutex;
+		std::vector<std::optional<Data>> m_parts;
+		std::vector<bool> m_dirty;
+		bool m_emit_pending = false;
+
+		/// accessed only from gui executor
+		Data m_merged;
+
+		std::vector<ext::net::subscription_handle> m_children;
+
+	protected:
+		void do_close_request(unique_lock lk) override;
+		void do_pause_request(unique_lock lk) override;
+		void do_resume_request(unique_lock lk) override;
+
+	public:
+		void set_part(std::size_t idx, Data & data);
+		void emit_merged();
+
+	public:
+		merged_subscription(multi_data_source * owner, handler_type handler, merge_function merge)
+			: m_owner(owner), m_handler(std::move(handler)), m_merge(merge),
+			  m_parts(owner->m_children.size()), m_dirty(owner->m_children.size()) {}
+	};
+
+	template <class Data>
+	void multi_data_source::merged_subscription<Data>::set_part(std::size_t idx, Data & data)
+	{
+		std::unique_lock lk(m_data_mutex);
+		m_parts[idx] = std::move(data);
+		m_dirty[idx] = true;
+
+		if (m_emit_pending)
+		{
+			metrics::pipeline().snapshots_coalesced.add();
+			return;
+		}
+
+		m_emit_pending = true;
+		lk.unlock();
+
+		m_owner->post([that = ext::intrusive_ptr<merged_subscription>(this)] { that->emit_merged(); });
+	}
+
+	template <class Data>
+	void multi_data_source::merged_subscription<Data>::emit_merged()
+	{
+		{
+			std::lock_guard lk(m_data_mutex);
+			m_emit_pending = false;
+
+			m_merge(m_merged, m_parts, m_dirty);
+			m_dirty.assign(m_dirty.size(), false);
+		}
+
+		if (get_state() != opened)
+		{
+			metrics::pipeline().snapshots_dropped.add();
+			return;
+		}
+
+		m_handler(m_merged);
+	}
+
+	template <class Data>
+	void multi_data_source::merged_subscription<Data>::do_close_request(unique_lock lk)
+	{
+		// children handlers hold reference to this object, closing them breaks the cycle
+		for (auto & child : m_children)
+			child.close();
+
+		m_children.clear();
+		notify_closed(std::move(lk));
+	}
+
+	template <class Data>
+	void multi_data_source::merged_subscription<Data>::do_pause_request(unique_lock lk)
+	{
+		for (auto & child : m_children)
+			child.pause();
+
+		notify_paused(std::move(lk));
+	}
+
+	template <class Data>
+	void multi_data_source::merged_subscription<Data>::do_resume_request(unique_lock lk)
+	{
+		for (auto & child : m_children)
+			child.resume();
+
+		notify_resumed(std::move(lk));
+	}
+
+	/// merged list is ordered by child, child index is in id prefix:
+	/// slices of clean children are moved over as is, slices of dirty ones are replaced by their new parts
+	static void merge_torrents(torrent_list & merged, std::vector<std::optional<torrent_list>> & parts, const std::vector<bool> & dirty)
+	{
+		torrent_list result;
+		result.reserve(merged.size());
+
+		auto first = merged.begin(), last = merged.end();
+		for (std::size_t idx = 0; idx < parts.size(); ++idx)
+		{
+			auto prefix = static_cast<torrent_id_type>(idx + 1);
+			auto slice_last = std::find_if(first, last, [prefix](auto & torr) { return torr.id() >> multi_data_source::ms_child_shift != prefix; });
+
+			if (not dirty[idx])
+				result.insert(result.end(), std::make_move_iterator(first), std::make_move_iterator(slice_last));
+			else
+			{
+				auto & part = *parts[idx];
+				result.insert(result.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+				part.clear();
+			}
+
+			first = slice_last;
+		}
+
+		merged = std::move(result);
+	}
+
+	static void merge_session_stats(session_stat & result, const session_stat & part)
+	{
+		result.download_speed       += part.download_speed;
+		result.upload_speed         += part.upload_speed;
+		result.torrent_count        += part.torrent_count;
+		result.active_torrent_count += part.active_torrent_count;
+		result.paused_torrent_count += part.paused_torrent_count;
+		result.downloaded_bytes     += part.downloaded_bytes;
+		result.uploaded_bytes       += part.uploaded_bytes;
+
+		// daemons are on different hosts, their disks are distinct
+		if (part.free_space)
+			result.free_space = result.free_space.value_or(0) + *part.free_space;
+	}
+
+	/// session stats are small, they are summed anew from latest stats of every child
+	static void merge_session_parts(session_stat & merged, std::vector<std::optional<session_stat>> & parts, const std::vector<bool> & dirty)
+	{
+		merged = {};
+		for (auto & part : parts)
+			if (part) merge_session_stats(merged, *part);
+	}
+
+	template <class Map>
+	static void merge_map(Map & result, Map & part, std::size_t child)
+	{
+		for (auto & [id, value] : part)
+			result.emplace(multi_data_source::make_id(child, id), std::move(value));
+	}
+
+	template <class Action>
+	void multi_data_source::post(Action && action)
+	{
+		if (not m_executor)
+			action();
+		else
+			m_executor->submit(std::forward<Action>(action));
+	}
+
+	auto multi_data_source::make_id(std::size_t child, const torrent_id_type & id) -> torrent_id_type
+	{
+		// zero prefix is reserved for not namespaced ids
+		return static_cast<torrent_id_type>(child + 1) << ms_child_shift | id;
+	}
+
+	auto multi_data_source::split_id(const torrent_id_type & id) -> std::pair<std::size_t, torrent_id_type>
+	{
+		auto prefix = static_cast<std::size_t>(id >> ms_child_shift);
+		if (prefix == 0)
+			throw std::invalid_argument("multi_data_source: torrent id without source prefix: " + std::to_string(id));
+
+		return {prefix - 1, id & ((torrent_id_type(1) << ms_child_shift) - 1)};
+	}
+
+	auto multi_data_source::split_ids(const torrent_id_list & ids) const -> std::vector<torrent_id_list>
+	{
+		std::vector<torrent_id_list> result(m_children.size());
+		for (auto & id : ids)
+		{
+			auto [child, child_id] = split_id(id);
+			if (child >= m_children.size())
+				throw std::out_of_range("multi_data_source: torrent id of unknown source: " + std::to_string(id));
+
+			result[child].push_back(std::move(child_id));
+		}
+
+		return result;
+	}
+
+	template <class Method>
+	auto multi_data_source::route_action(torrent_id_list ids, Method method) -> ext::future<void>
+	{
+		std::vector<ext::future<void>> results;
+		results.reserve(m_children.size());
+
+		// empty list means all torrents, every child should get it
+		auto split = ids.empty() ? std::vector<torrent_id_list>(m_children.size()) : split_ids(ids);
+		for (std::size_t idx = 0; idx < m_children.size(); ++idx)
+		{
+			if (not ids.empty() and split[idx].empty()) continue;
+			results.push_back(std::invoke(method, *m_children[idx].source, std::move(split[idx])));
+		}
+
+		auto all = ext::when_all(std::make_move_iterator(results.begin()), std::make_move_iterator(results.end()));
+		return all.then([](auto all)
+		{
+			// rethrows first failure, if any
+			for (auto & result : all.get())
+				result.get();
+		});
+	}
+
+	void multi_data_source::add_source(source_ptr source, string_type name)
+	{
+		source->set_gui_executor(nullptr);
+		m_children.push_back({std::move(source), std::move(name)});
+	}
+
+	void multi_data_source::do_connect_request(unique_lock lk)
+	{
+		// children connect in background, dead daemon should not prevent others from working
+		for (auto & child : m_children)
+			child.source->connect();
+
+		notify_connected(std::move(lk));
+	}
+
+	void multi_data_source::do_disconnect_request(unique_lock lk)
+	{
+		for (auto & child : m_children)
+			child.source->disconnect();
+
+		notify_disconnected(std::move(lk));
+	}
+
+	void multi_data_source::set_timeout(std::chrono::steady_clock::duration timeout)
+	{
+		for (auto & child : m_children)
+			child.source->set_timeout(timeout);
+	}
+
+	void multi_data_source::set_logger(ext::library_logger::logger * logger)
+	{
+		for (auto & child : m_children)
+			child.source->set_logger(logger);
+	}
+
+	auto multi_data_source::subscribe_torrents(torrent_handler handler) -> ext::net::subscription_handle
+	{
+		using subscription_type = merged_subscription<torrent_list>;
+		auto sub = ext::make_intrusive<subscription_type>(this, std::move(handler), merge_torrents);
+
+		for (std::size_t idx = 0; idx < m_children.size(); ++idx)
+		{
+			auto child_handler = [sub, idx](torrent_list & list)
+			{
+				for (auto & torr : list)
+					torr.id(make_id(idx, torr.id()));
+
+				sub->set_part(idx, list);
+			};
+
+			sub->m_children.push_back(m_children[idx].source->subscribe_torrents(child_handler));
+		}
+
+		return {sub};
+	}
+
+	auto multi_data_source::subscribe_session_stats(session_stat_handler handler) -> ext::net::subscription_handle
+	{
+		using subscription_type = merged_subscription<session_stat>;
+		auto sub = ext::make_intrusive<subscription_type>(this, std::move(handler), merge_session_parts);
+
+		for (std::size_t idx = 0; idx < m_children.size(); ++idx)
+		{
+			auto child_handler = [sub, idx](session_stat & stat) { sub->set_part(idx, stat); };
+			sub->m_children.push_back(m_children[idx].source->subscribe_session_stats(child_handler));
+		}
+
+		return {sub};
+	}
+
+	auto multi_data_source::get_session_stats() -> ext::future<session_stat>
+	{
+		std::vector<ext::future<session_stat>> results;
+		for (auto & child : m_children)
+			results.push_back(child.source->get_session_stats());
+
+		auto all = ext::when_all(std::make_move_iterator(results.begin()), std::make_move_iterator(results.end()));
+		return all.then([](auto all)
+		{
+			session_stat result;
+			for (auto & part : all.get())
+				merge_session_stats(result, part.get());
+
+			return result;
+		});
+	}
+
+	auto multi_data_source::get_torrents() -> ext::future<torrent_list>
+	{
+		return get_torrents(torrent_id_list());
+	}
+
+	auto multi_data_source::get_torrents(torrent_id_list ids) -> ext::future<torrent_list>
+	{
+		std::vector<std::size_t> children;
+		std::vector<ext::future<torrent_list>> results;
+
+		auto split = ids.empty() ? std::vector<torrent_id_list>(m_children.size()) : split_ids(ids);
+		for (std::size_t idx = 0; idx < m_children.size(); ++idx)
+		{
+			if (not ids.empty() and split[idx].empty()) continue;
+
+			children.push_back(idx);
+			results.push_back(m_children[idx].source->get_torrents(std::move(split[idx])));
+		}
+
+		auto all = ext::when_all(std::make_move_iterator(results.begin()), std::make_move_iterator(results.end()));
+		return all.then([children = std::move(children)](auto all)
+		{
+			torrent_list result;
+			auto parts = all.get();
+
+			for (std::size_t i = 0; i < parts.size(); ++i)
+			{
+				auto part = parts[i].get();
+				for (auto & torr : part)
+					torr.id(make_id(children[i], torr.id()));
+
+				result.insert(result.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+			}
+
+			return result;
+		});
+	}
+
+	auto multi_data_source::start_all_torrents() -> ext::future<void>
+	{
+		return route_action({}, &abstract_data_source::start_torrents);
+	}
+
+	auto multi_data_source::stop_all_torrents() -> ext::future<void>
+	{
+		return route_action({}, &abstract_data_source::stop_torrents);
+	}
+
+	auto multi_data_source::start_torrents(torrent_id_list ids) -> ext::future<void>
+	{
+		return route_action(std::move(ids), &abstract_data_source::start_torrents);
+	}
+
+	auto multi_data_source::start_torrents_now(torrent_id_list ids) -> ext::future<void>
+	{
+		return route_action(std::move(ids), &abstract_data_source::start_torrents_now);
+	}
+
+	auto multi_data_source::stop_torrents(torrent_id_list ids) -> ext::future<void>
+	{
+		return route_action(std::move(ids), &abstract_data_source::stop_torrents);
+	}
+
+	auto multi_data_source::verify_torrents(torrent_id_list ids) -> ext::future<void>
+	{
+		return route_action(std::move(ids), &abstract_data_source::verify_torrents);
+	}
+
+	auto multi_data_source::announce_torrents(torrent_id_list ids) -> ext::future<void>
+	{
+		return route_action(std::move(ids), &abstract_data_source::announce_torrents);
+	}
+
+	auto multi_data_source::remove_torrents(torrent_id_list ids) -> ext::future<void>
+	{
+		return route_action(std::move(ids), &abstract_data_source::remove_torrents);
+	}
+
+	auto multi_data_source::purge_torrents(torrent_id_list ids) -> ext::future<void>
+	{
+		return route_action(std::move(ids), &abstract_data_source::purge_torrents);
+	}
+
+	auto multi_data_source::set_torrent_location(torrent_id_type id, std::string newloc, bool move) -> ext::future<void>
+	{
+		auto [child, child_id] = split_id(id);
+		return m_children.at(child).source->set_torrent_location(std::move(child_id), std::move(newloc), move);
+	}
+
+	auto multi_data_source::get_torrent_files(torrent_id_type id) -> ext::future<torrent_file_list>
+	{
+		auto [child, child_id] = split_id(id);
+		return m_children.at(child).source->get_torrent_files(std::move(child_id));
+	}
+
+	auto multi_data_source::get_torrent_peers(torrent_id_type id) -> ext::future<torrent_peer_list>
+	{
+		auto [child, child_id] = split_id(id);
+		return m_children.at(child).source->get_torrent_peers(std::move(child_id));
+	}
+
+	auto multi_data_source::get_trackers(torrent_id_type id) -> ext::future<tracker_list>
+	{
+		auto [child, child_id] = split_id(id);
+		return m_children.at(child).source->get_trackers(std::move(child_id));
+	}
+
+	auto multi_data_source::get_torrent_files(torrent_id_list ids) -> ext::future<torrent_file_map>
+	{
+		std::vector<std::size_t> children;
+		std::vector<ext::future<torrent_file_map>> results;
+
+		auto split = split_ids(ids);
+		for (std::size_t idx = 0; idx < m_children.size(); ++idx)
+		{
+			if (split[idx].empty()) continue;
+
+			children.push_back(idx);
+			results.push_back(m_children[idx].source->get_torrent_files(std::move(split[idx])));
+		}
+
+		auto all = ext::when_all(std::make_move_iterator(results.begin()), std::make_move_iterator(results.end()));
+		return all.then([children = std::move(children)](auto all)
+		{
+			torrent_file_map result;
+			auto parts = all.get();
+
+			for (std::size_t i = 0; i < parts.size(); ++i)
+			{
+				auto part = parts[i].get();
+				merge_map(result, part, children[i]);
+			}
+
+			return result;
+		});
+	}
+
+	auto multi_data_source::get_trackers(torrent_id_list ids) -> ext::future<tracker_map>
+	{
+		std::vector<std::size_t> children;
+		std::vector<ext::future<tracker_map>> results;
+
+		auto split = split_ids(ids);
+		for (std::size_t idx = 0; idx < m_children.size(); ++idx)
+		{
+			if (split[idx].empty()) continue;
+
+			children.push_back(idx);
+			results.push_back(m_children[idx].source->get_trackers(std::move(split[idx])));
+		}
+
+		auto all = ext::when_all(std::make_move_iterator(results.begin()), std::make_move_iterator(results.end()));
+		return all.then([children = std::move(children)](auto all)
+		{
+			tracker_map result;
+			auto parts = all.get();
+
+			for (std::size_t i = 0; i < parts.size(); ++i)
+			{
+				auto part = parts[i].get();
+				merge_map(result, part, children[i]);
+			}
+
+			return result;
+		});
+	}
+
+	auto multi_data_source::get_torrent_detail(torrent_id_type id) -> ext::future<torrent_detail>
+	{
+		auto [child, child_id] = split_id(id);
+		auto result = m_children.at(child).source->get_torrent_detail(std::move(child_id));
+
+		return result.then([id = std::move(id)](auto result)
+		{
+			auto detail = result.get();
+			detail.id = id;
+			return detail;
+		});
+	}
+
+	auto multi_data_source::subscribe_torrent_detail(torrent_id_type id, torrent_detail_handler handler) -> ext::net::subscription_handle
+	{
+		auto [child, child_id] = split_id(id);
+		auto shared_handler = std::make_shared<torrent_detail_handler>(std::move(handler));
+
+		auto child_handler = [this, shared_handler, id](torrent_detail & detail)
+		{
+			detail.id = id;
+			post([shared_handler, detail = std::move(detail)]() mutable { (*shared_handler)(detail); });
+		};
+
+		return m_children.at(child).source->subscribe_torrent_detail(std::move(child_id), child_handler);
+	}
+
+	auto multi_data_source::subscribe_torrent_peers(torrent_id_type id, torrent_peer_handler handler) -> ext::net::subscription_handle
+	{
+		auto [child, child_id] = split_id(id);
+		auto shared_handler = std::make_shared<torrent_peer_handler>(std::move(handler));
+
+		auto child_handler = [this, shared_handler](torrent_peer_diff & diff)
+		{
+			post([shared_handler, diff = std::move(diff)]() mutable { (*shared_handler)(diff); });
+		};
+
+		return m_children.at(child).source->subscribe_torrent_peers(std::move(child_id), child_handler);
+	}
+
+	auto multi_data_source::subscribe_torrent_files(torrent_id_type id, torrent_file_handler handler) -> ext::net::subscription_handle
+	{
+		auto [child, child_id] = split_id(id);
+		auto shared_handler = std::make_shared<torrent_file_handler>(std::move(handler));
+
+		auto child_handler = [this, shared_handler](torrent_file_update & update)
+		{
+			post([shared_handler, update = std::move(update)]() mutable { (*shared_handler)(update); });
+		};
+
+		return m_children.at(child).source->subscribe_torrent_files(std::move(child_id), child_handler);
+	}
+
+	std::string multi_data_source::last_errormsg() const
+	{
+		std::string result;
+		for (auto & child : m_children)
+		{
+			auto err = child.source->last_errormsg();
+			if (err.empty()) continue;
+
+			if (not result.empty()) result += "; ";
+			result += QtTools::FromQString(child.name);
+			result += ": ";
+			result += err;
+		}
+
+		return result;
+	}
+
+	auto multi_data_source::last_latency() const -> duration
+	{
+		duration result = {};
+		for (auto & child : m_children)
+			result = std::max(result, child.source->last_latency());
+
+		return result;
+	}
+}
@@ -17,6 +17,41 @@ namespace qtor
 		return m_ascending ? v1 < v2 : v2 < v1;
 	}
 
+	static bool same_value(const sparse_container::any_type & v1, const sparse_container::any_type & v2)
+	{
+		// interned strings share buffer, see string_pool: same buffer is same string without comparing characters
+		if (v1.userType() == QMetaType::QString and v2.userType() == QMetaType::QString)
+		{
+			auto * s1 = static_cast<const QString *>(v1.constData());
+			auto * s2 = static_cast<const QString *>(v2.constData());
+			return s1->constData() == s2->constData() or *s1 == *s2;
+		}
+
+		return v1 == v2;
+	}
+
+	field_mask changed_fields(const sparse_container & c1, const sparse_container & c2)
+	{
+		field_mask result = 0;
+		auto & items1 = c1.items();
+		auto & items2 = c2.items();
+
+		for (auto & [key, val] : items1)
+		{
+			auto it = items2.find(key);
+			if (it == items2.end() or not same_value(it->second, val))
+				result |= field_bit(key);
+		}
+
+		for (auto & [key, val] : items2)
+		{
+			if (not items1.count(key))
+				result |= field_bit(key);
+		}
+
+		return result;
+	}
+
 	static std::uint32_t toupper(std::uint32_t ch)
 	{
 #if 0
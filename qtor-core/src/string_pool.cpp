@@ -0,0 +1,80 @@
+#include <qtor/string_pool.hpp>
+#include <qtor/metrics.hpp>
+#include <algorithm>
+
+namespace qtor
+{
+	// QString buffer: header, characters and terminating null
+	static std::size_t buffer_size(const QString & str) noexcept
+	{
+		return sizeof(QArrayData) + (str.size() + 1) * sizeof(QChar);
+	}
+
+	// owners of string buffer, negative for static data
+	static int ref_count(const QString & str) noexcept
+	{
+		auto & ref = const_cast<QString &>(str).data_ptr()->ref;
+	#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+		return ref.atomic.loadRelaxed();
+	#else
+		return ref.atomic.load();
+	#endif
+	}
+
+	void string_pool::report(std::size_t size, std::size_t shared)
+	{
+		auto & metrics = metrics::pipeline();
+		metrics.string_pool_size.add(static_cast<std::int64_t>(size) - static_cast<std::int64_t>(m_reported_size));
+		metrics.string_pool_shared_bytes.add(static_cast<std::int64_t>(shared) - static_cast<std::int64_t>(m_reported_shared));
+
+		m_reported_size = size;
+		m_reported_shared = shared;
+	}
+
+	auto string_pool::intern(const QString & str) -> QString
+	{
+		if (str.isEmpty()) return str;
+
+		auto [it, inserted] = m_strings.insert(str);
+		if (not inserted) return *it;
+
+		if (m_strings.size() >= m_collect_threshold)
+		{
+			// collect can't drop just inserted string - str still shares its buffer
+			QString result = *it;
+			collect();
+			return result;
+		}
+
+		return *it;
+	}
+
+	void string_pool::collect()
+	{
+		std::size_t shared = 0;
+		for (auto it = m_strings.begin(); it != m_strings.end();)
+		{
+			auto refs = ref_count(*it);
+			// detached - nobody shares buffer with pool entry anymore
+			if (refs == 1)
+			{
+				it = m_strings.erase(it);
+				continue;
+			}
+
+			// pool entry and first user would hold buffer anyway, every other user would have own copy
+			if (refs > 2)
+				shared += (refs - 2) * buffer_size(*it);
+
+			++it;
+		}
+
+		m_collect_threshold = std::max<std::size_t>(1024, m_strings.size() * 2);
+		report(m_strings.size(), shared);
+	}
+
+	string_pool::~string_pool()
+	{
+		report(0, 0);
+	}
+}
@@ -1,4 +1,5 @@
 #include <qtor/torrent.hpp>
+#include <qtor/torrent_category.hpp>
 #include <qtor/FileTreeModel.hqt>
 #include <ext/config.hpp>
 #include <boost/preprocessor/stringize.hpp>
@@ -7,6 +8,57 @@ namespace qtor
 {
 	const string_type torrent::ms_emptystr;
 
+	bool operator ==(const torrent_peer & p1, const torrent_peer & p2) noexcept
+	{
+		return p1.port == p2.port
+		   and p1.address == p2.address
+		   and p1.client_choked == p2.client_choked
+		   and p1.client_interested == p2.client_interested
+		   and p1.downloading_from == p2.downloading_from
+		   and p1.uploading_to == p2.uploading_to
+		   and p1.encrypted == p2.encrypted
+		   and p1.incoming == p2.incoming
+		   and p1.peer_choked == p2.peer_choked
+		   and p1.peer_interested == p2.peer_interested
+		   and p1.rate_to_client == p2.rate_to_client
+		   and p1.rate_to_peer == p2.rate_to_peer
+		   and p1.progress == p2.progress
+		   and p1.flag_str == p2.flag_str
+		   and p1.client_name == p2.client_name;
+	}
+
+	string_type peer_key(const torrent_peer & peer)
+	{
+		return peer.address + ':' + QString::number(peer.port);
+	}
+
+	torrent_category_set torrent_categories(const torrent & torr) noexcept
+	{
+		torrent_category_set result;
+		const auto status = torr.status();
+		const auto requested_size = torr.requested_size();
+		const auto current_size = torr.current_size();
+		const auto error_string = torr.error_string();
+
+		const bool all = true;
+		const bool error = error_string.has_value();
+		const bool stopped = status == torrent_status::stopped;
+		const bool active = not stopped and not error;
+		const bool nonactive = not stopped;
+		const bool downloading = status == torrent_status::downloading or status == torrent_status::downloading_queued;
+		const bool downloaded = current_size == requested_size;
+
+		result.set(torrent_category::all, all);
+		result.set(torrent_category::error, error);
+		result.set(torrent_category::stopped, stopped);
+		result.set(torrent_category::active, active);
+		result.set(torrent_category::nonactive, nonactive);
+		result.set(torrent_category::downloading, downloading);
+		result.set(torrent_category::downloaded, downloaded);
+
+		return result;
+	}
+
 #define QTOR_TORRENT_FORMATTER_ITEM(A0, ID, NAME, TYPE, TYPENAME) \
 		(*types)[torrent::ID] = item {                        \
 			type_map[BOOST_PP_STRINGIZE(TYPE)],               \
@@ -20,6 +72,7 @@ namespace qtor
 			std::unordered_map<string_type, unsigned> type_map =
 			{
 				{"uint64", Uint64},
+				{"int64", Int64},
 				{"bool", Bool},
 				{"double", Double},
 				{"string", String},
@@ -0,0 +1,231 @@
+#include <qtor/torrent_aggregator.hpp>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+namespace qtor
+{
+	static auto extract_values(const torrent & torr, const std::vector<sparse_container::index_type> & fields) -> torrent_aggregate::value_list
+	{
+		torrent_aggregate::value_list values;
+		values.reserve(fields.size());
+
+		for (auto field : fields)
+		{
+			// missing fields are null variants, those do not convert.
+			// NaN is not counted either, it can't be ordered among min/max values
+			bool ok;
+			auto val = torr.get_item(field).toDouble(&ok);
+			values.push_back(ok and not std::isnan(val) ? optional<double>(val) : nullopt);
+		}
+
+		return values;
+	}
+
+	/************************************************************************/
+	/*                   torrent_aggregate                                  */
+	/************************************************************************/
+	void torrent_aggregate::add(const value_list & values)
+	{
+		assert(values.size() == m_fields.size());
+
+		for (std::size_t i = 0; i < m_states.size(); ++i)
+		{
+			if (not values[i]) continue;
+
+			auto & state = m_states[i];
+			state.count += 1;
+			state.sum += *values[i];
+			if (state.ordered) state.values[*values[i]] += 1;
+		}
+
+		m_torrent_count += 1;
+	}
+
+	void torrent_aggregate::remove(const value_list & values)
+	{
+		assert(values.size() == m_fields.size());
+		assert(m_torrent_count > 0);
+
+		for (std::size_t i = 0; i < m_states.size(); ++i)
+		{
+			if (not values[i]) continue;
+
+			auto & state = m_states[i];
+			if (state.ordered)
+			{
+				auto it = state.values.find(*values[i]);
+				assert(it != state.values.end());
+
+				if (--it->second == 0)
+					state.values.erase(it);
+			}
+
+			// do not leave rounding residue once field is gone
+			if (--state.count == 0)
+				state.sum = 0;
+			else
+				state.sum -= *values[i];
+		}
+
+		m_torrent_count -= 1;
+	}
+
+	void torrent_aggregate::clear()
+	{
+		m_torrent_count = 0;
+		for (auto & state : m_states)
+		{
+			state.sum = 0;
+			state.count = 0;
+			state.values.clear();
+		}
+	}
+
+	auto torrent_aggregate::stats(index_type field) const -> field_stats
+	{
+		auto it = std::find(m_fields.begin(), m_fields.end(), field);
+		if (it == m_fields.end()) return {};
+
+		auto & state = m_states[it - m_fields.begin()];
+		if (state.count == 0) return {};
+
+		field_stats stats;
+		stats.count = state.count;
+		stats.sum = state.sum;
+		if (state.ordered)
+		{
+			stats.min = state.values.begin()->first;
+			stats.max = state.values.rbegin()->first;
+		}
+
+		return stats;
+	}
+
+	torrent_aggregate::torrent_aggregate(std::vector<index_type> fields, const std::vector<index_type> & ordered_fields /* = {} */)
+		: m_fields(std::move(fields)), m_states(m_fields.size())
+	{
+		for (std::size_t i = 0; i < m_fields.size(); ++i)
+			m_states[i].ordered = std::find(ordered_fields.begin(), ordered_fields.end(), m_fields[i]) != ordered_fields.end();
+	}
+
+	/************************************************************************/
+	/*                   torrent_aggregator                                 */
+	/************************************************************************/
+	auto torrent_aggregator::default_fields() -> std::vector<index_type>
+	{
+		return {
+			torrent::DownloadSpeed, torrent::UploadSpeed,
+			torrent::TotalSize, torrent::RequestedSize, torrent::CurrentSize, torrent::LeftSize,
+			torrent::EverUploaded, torrent::EverDownloaded, torrent::Ratio,
+		};
+	}
+
+	void torrent_aggregator::account(const entry & e, bool add)
+	{
+		auto apply = [&e, add](torrent_aggregate & agg) { add ? agg.add(e.values) : agg.remove(e.values); };
+
+		apply(m_total);
+		if (e.selected) apply(m_selection);
+
+		// all category is total itself
+		for (unsigned cat = torrent_category::all + 1; cat < torrent_category::count; ++cat)
+			if (e.categories[static_cast<torrent_category_type>(cat)])
+				apply(m_categories[cat - 1]);
+	}
+
+	void torrent_aggregator::insert(const torrent * ptr)
+	{
+		auto [it, inserted] = m_entries.try_emplace(ptr);
+		auto & e = it->second;
+
+		// recounted: withdraw previous contribution, categories could have changed too
+		if (not inserted) account(e, false);
+
+		e.categories = torrent_categories(*ptr);
+		e.selected = m_selected_ids.count(ptr->id());
+		e.values = extract_values(*ptr, m_fields);
+		account(e, true);
+	}
+
+	void torrent_aggregator::erase(const torrent * ptr)
+	{
+		auto it = m_entries.find(ptr);
+		if (it == m_entries.end()) return;
+
+		account(it->second, false);
+		m_entries.erase(it);
+	}
+
+	void torrent_aggregator::reset()
+	{
+		m_entries.clear();
+		m_total.clear();
+		m_selection.clear();
+		for (auto & agg : m_categories)
+			agg.clear();
+	}
+
+	template <class Range>
+	void torrent_aggregator::on_update(const Range & erased, const Range & updated, const Range & inserted)
+	{
+		auto relevant = m_fields_mask | torrent_category_fields;
+
+		for (const torrent * ptr : erased)
+			erase(ptr);
+
+		// records are updated in place, only those with changed aggregated fields need recounting
+		for (const torrent * ptr : updated)
+			if (m_store->last_changed_fields(ptr->id()) & relevant or not m_entries.count(ptr))
+				insert(ptr);
+
+		for (const torrent * ptr : inserted)
+			insert(ptr);
+	}
+
+	void torrent_aggregator::set_selection(const torrent_id_list & ids)
+	{
+		for (auto id : m_selected_ids)
+		{
+			auto it = m_store->find(id);
+			if (it == m_store->end()) continue;
+
+			auto eit = m_entries.find(&*it);
+			if (eit != m_entries.end()) eit->second.selected = false;
+		}
+
+		m_selection.clear();
+		m_selected_ids.clear();
+		m_selected_ids.insert(ids.begin(), ids.end());
+
+		for (auto id : m_selected_ids)
+		{
+			auto it = m_store->find(id);
+			if (it == m_store->end()) continue;
+
+			auto eit = m_entries.find(&*it);
+			if (eit == m_entries.end()) continue;
+
+			eit->second.selected = true;
+			m_selection.add(eit->second.values);
+		}
+	}
+
+	torrent_aggregator::torrent_aggregator(std::shared_ptr<torrent_store> store, std::vector<index_type> fields /* = default_fields() */, std::vector<index_type> ordered_fields /* = {} */)
+		: m_store(std::move(store)), m_fields(std::move(fields)),
+		  m_total(m_fields, ordered_fields), m_selection(m_fields, ordered_fields)
+	{
+		for (auto field : m_fields)
+			m_fields_mask |= field_bit(field);
+
+		for (auto & agg : m_categories)
+			agg = torrent_aggregate(m_fields, ordered_fields);
+
+		for (auto & torr : *m_store)
+			insert(&torr);
+
+		m_update_conn = m_store->on_update([this](const auto & erased, const auto & updated, const auto & inserted) { on_update(erased, updated, inserted); });
+		m_erase_conn = m_store->on_erase([this](const auto & erased) { for (const torrent * ptr : erased) erase(ptr); });
+		m_clear_conn = m_store->on_clear([this] { reset(); });
+	}
+}
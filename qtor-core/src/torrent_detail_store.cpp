@@ -0,0 +1,29 @@
+#include <qtor/torrent_detail_store.hpp>
+
+namespace qtor
+{
+	auto torrent_detail_store::subscribe() -> ext::net::subscription_handle
+	{
+		auto handler = guarded([this](torrent_detail & detail) { assign(detail); });
+		return m_source->subscribe_torrent_detail(m_torrent_id, handler);
+	}
+
+	void torrent_detail_store::assign(torrent_detail & detail)
+	{
+		m_detail = std::move(detail);
+		m_onupdate_signal(m_detail);
+	}
+
+	torrent_detail_store::torrent_detail_store(torrent_id_type torrent_id, std::shared_ptr<abstract_data_source> source)
+		: m_torrent_id(std::move(torrent_id)), m_source(std::move(source))
+	{
+		m_detail.id = m_torrent_id;
+	}
+
+	torrent_detail_store::~torrent_detail_store()
+	{
+		// subscription handler references this object
+		if (m_subsription_handle)
+			m_subsription_handle.close();
+	}
+}
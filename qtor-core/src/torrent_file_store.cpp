@@ -1,15 +1,118 @@
 ﻿#include <qtor/torrent_file_store.hpp>
+#include <qtor/update_scheduler.hpp>
 #include <QtCore/QPointer>
 #include <QtCore/QDebug>
+#include <algorithm>
 
 namespace qtor
 {
+	auto torrent_file_store::subscribe() -> ext::net::subscription_handle
+	{
+		auto handler = guarded([this](torrent_file_update & update) { post_update(update); });
+		return m_source->subscribe_torrent_files(m_torrent_id, handler);
+	}
+
+	void torrent_file_store::post_update(torrent_file_update & update)
+	{
+		// full list replaces whatever is pending, stats are absolute values: newer ones replace older.
+		// Stats following pending full list are folded into its files
+		if (not m_pending_update or update.full)
+			m_pending_update = std::move(update);
+		else if (not m_pending_update->full)
+			m_pending_update->stats = std::move(update.stats);
+		else
+		{
+			for (auto & file : m_pending_update->files)
+			{
+				if (file.index < 0 or static_cast<std::size_t>(file.index) >= update.stats.size()) continue;
+
+				auto & stat = update.stats[file.index];
+				file.have_size = stat.have_size;
+				file.priority = stat.priority;
+				file.wanted = stat.wanted;
+			}
+		}
+
+		update_scheduler::instance().post(this, [this] { flush_pending(); });
+	}
+
+	void torrent_file_store::flush_pending()
+	{
+		if (not m_pending_update) return;
+
+		auto update = std::move(*m_pending_update);
+		m_pending_update.reset();
+		apply_update(update);
+	}
+
+	void torrent_file_store::apply_update(torrent_file_update & update)
+	{
+		if (update.full)
+		{
+			m_by_index.assign(update.files.size(), filepath_type());
+			for (auto & file : update.files)
+			{
+				if (file.index < 0) continue;
+				if (static_cast<std::size_t>(file.index) >= m_by_index.size())
+					m_by_index.resize(file.index + 1);
+
+				m_by_index[file.index] = file.filename;
+			}
+
+			assign_records(std::move(update.files));
+			return;
+		}
+
+		torrent_file_list changed;
+		auto count = std::min(update.stats.size(), m_by_index.size());
+
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			auto it = find(m_by_index[index]);
+			if (it == end()) continue;
+
+			auto & stat = update.stats[index];
+			if (it->have_size == stat.have_size and it->priority == stat.priority and it->wanted == stat.wanted)
+				continue;
+
+			auto file = *it;
+			file.have_size = stat.have_size;
+			file.priority = stat.priority;
+			file.wanted = stat.wanted;
+			changed.push_back(std::move(file));
+		}
+
+		if (not changed.empty())
+			upsert_records(std::move(changed));
+	}
+
 	void torrent_file_store::refresh()
 	{
 		auto * executor = m_source->get_gui_executor();
 		assert(executor);
 
 		auto ffiles = m_source->get_torrent_files(m_torrent_id);
-		executor->submit(std::move(ffiles), [this](auto ffiles) { assign_records(std::move(ffiles.get())); });
+		executor->submit(std::move(ffiles), guarded([this](auto ffiles)
+		{
+			torrent_file_update update;
+			update.full = true;
+			update.files = ffiles.get();
+			apply_update(update);
+		}));
+	}
+
+	torrent_file_store::torrent_file_store(torrent_id_type torrent_id, std::shared_ptr<abstract_data_source> source)
+		: m_torrent_id(std::move(torrent_id)), m_source(std::move(source))
+	{
+
+	}
+
+	torrent_file_store::~torrent_file_store()
+	{
+		update_scheduler::instance().cancel(this);
+
+		// subscription handler references this object
+		if (m_subsription_handle)
+			m_subsription_handle.close();
 	}
 }
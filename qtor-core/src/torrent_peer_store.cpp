@@ -0,0 +1,35 @@
+#include <qtor/torrent_peer_store.hpp>
+
+namespace qtor
+{
+	auto torrent_peer_store::subscribe() -> ext::net::subscription_handle
+	{
+		auto handler = guarded([this](torrent_peer_diff & diff) { apply_diff(diff); });
+		return m_source->subscribe_torrent_peers(m_torrent_id, handler);
+	}
+
+	void torrent_peer_store::apply_diff(torrent_peer_diff & diff)
+	{
+		if (not diff.removed.empty())
+			erase(diff.removed.begin(), diff.removed.end());
+
+		auto & added = diff.added;
+		added.insert(added.end(), std::make_move_iterator(diff.changed.begin()), std::make_move_iterator(diff.changed.end()));
+
+		if (not added.empty())
+			upsert(std::make_move_iterator(added.begin()), std::make_move_iterator(added.end()));
+	}
+
+	torrent_peer_store::torrent_peer_store(torrent_id_type torrent_id, std::shared_ptr<abstract_data_source> source)
+		: m_torrent_id(std::move(torrent_id)), m_source(std::move(source))
+	{
+
+	}
+
+	torrent_peer_store::~torrent_peer_store()
+	{
+		// subscription handler references this object
+		if (m_subsription_handle)
+			m_subsription_handle.close();
+	}
+}
@@ -0,0 +1,320 @@
+#include <qtor/torrent_snapshot.hpp>
+#include <qtor/tracing.hpp>
+#include <QtCore/QSaveFile>
+
+#include <limits>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace qtor
+{
+	namespace snapshot = torrent_snapshot_format;
+
+	static_assert(sizeof(snapshot::header) == 48);
+	static_assert(sizeof(snapshot::field_entry) == 32);
+	static_assert(sizeof(snapshot::string_ref) == 8);
+	static_assert(sizeof(QChar) == sizeof(char16_t));
+
+	static constexpr std::size_t align8(std::size_t val) noexcept { return (val + 7) & ~std::size_t(7); }
+	static constexpr std::size_t presence_words(std::size_t count) noexcept { return (count + 63) / 64; }
+
+	static auto as_string(const QString & path) { return path.toStdString(); }
+
+	/// encodes field value into 8 byte slot, returns false if torrent has no such field
+	static bool encode_value(const torrent & torr, sparse_container::index_type key, unsigned type,
+	                         std::vector<char16_t> & heap, std::uint64_t & slot)
+	{
+		auto store = [&slot](auto val) { std::memcpy(&slot, &val, sizeof(slot)); return true; };
+		auto ns = [](auto dur) { return static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(dur).count()); };
+
+		switch (type)
+		{
+			case model_meta::Speed:
+			case model_meta::Size:
+			case model_meta::Uint64:
+				if (auto val = torr.get_item<uint64_type>(key)) return store(*val);
+				return false;
+
+			case model_meta::Int64:
+				if (auto val = torr.get_item<int64_type>(key)) return store(*val);
+				return false;
+
+			case model_meta::Bool:
+				if (auto val = torr.get_item<bool>(key)) return store(std::uint64_t(*val));
+				return false;
+
+			case model_meta::Ratio:
+			case model_meta::Percent:
+			case model_meta::Double:
+				if (auto val = torr.get_item<double>(key)) return store(*val);
+				return false;
+
+			case model_meta::DateTime:
+				if (auto val = torr.get_item<datetime_type>(key)) return store(ns(val->time_since_epoch()));
+				return false;
+
+			case model_meta::Duration:
+				if (auto val = torr.get_item<duration_type>(key)) return store(ns(*val));
+				return false;
+
+			case model_meta::String:
+				if (auto val = torr.get_item<string_type>(key))
+				{
+					snapshot::string_ref ref;
+					ref.offset = static_cast<std::uint32_t>(heap.size());
+					ref.length = static_cast<std::uint32_t>(val->size());
+
+					auto * first = reinterpret_cast<const char16_t *>(val->utf16());
+					heap.insert(heap.end(), first, first + val->size());
+					return store(ref);
+				}
+
+				return false;
+
+			default:
+				return false;
+		}
+	}
+
+	void write_torrent_snapshot(const QString & path, const torrent_list & torrents)
+	{
+		QTOR_TRACE_SCOPE("write_torrent_snapshot");
+
+		struct field
+		{
+			sparse_container::index_type key;
+			unsigned type;
+			QString name;
+		};
+
+		auto & meta = default_torrent_meta();
+		std::vector<field> fields;
+		for (sparse_container::index_type key = 0; key < torrent::LastField; ++key)
+		{
+			auto type = meta.item_type(key);
+			if (type == model_meta::Unknown or meta.is_virtual_item(key)) continue;
+
+			fields.push_back({key, type, meta.item_name(key)});
+		}
+
+		auto count = torrents.size();
+		auto values_size = count * sizeof(std::uint64_t);
+		auto presence_size = presence_words(count) * sizeof(std::uint64_t);
+
+		// header, field table, columns - heap goes last, its size is known only after columns are encoded
+		auto fields_offset = align8(sizeof(snapshot::header));
+		auto columns_offset = align8(fields_offset + fields.size() * sizeof(snapshot::field_entry));
+		auto heap_offset = columns_offset + fields.size() * (values_size + presence_size);
+
+		std::vector<char> data(heap_offset);
+		std::vector<char16_t> heap;
+
+		auto * entries = reinterpret_cast<snapshot::field_entry *>(data.data() + fields_offset);
+		for (std::size_t i = 0; i < fields.size(); ++i)
+		{
+			auto & fld = fields[i];
+			auto & entry = entries[i];
+			auto values_offset = columns_offset + i * (values_size + presence_size);
+
+			entry.type = fld.type;
+			entry.name_offset = static_cast<std::uint32_t>(heap.size());
+			entry.name_length = static_cast<std::uint32_t>(fld.name.size());
+			entry.reserved = 0;
+			entry.values_offset = values_offset;
+			entry.presence_offset = values_offset + values_size;
+
+			auto * name = reinterpret_cast<const char16_t *>(fld.name.utf16());
+			heap.insert(heap.end(), name, name + fld.name.size());
+
+			auto * values = reinterpret_cast<std::uint64_t *>(data.data() + entry.values_offset);
+			auto * presence = reinterpret_cast<std::uint64_t *>(data.data() + entry.presence_offset);
+
+			for (std::size_t row = 0; row < count; ++row)
+				if (encode_value(torrents[row], fld.key, fld.type, heap, values[row]))
+					presence[row / 64] |= std::uint64_t(1) << (row % 64);
+		}
+
+		if (heap.size() > std::numeric_limits<std::uint32_t>::max())
+			throw std::runtime_error("torrent snapshot string heap is too big");
+
+		auto & header = *reinterpret_cast<snapshot::header *>(data.data());
+		std::memcpy(header.magic, snapshot::magic, sizeof(header.magic));
+		header.version = snapshot::version;
+		header.field_count = static_cast<std::uint32_t>(fields.size());
+		header.torrent_count = count;
+		header.fields_offset = fields_offset;
+		header.heap_offset = heap_offset;
+		header.heap_size = heap.size();
+
+		// readers never see partially written file
+		QSaveFile file(path);
+		if (not file.open(QIODevice::WriteOnly))
+			throw std::runtime_error("failed to open " + as_string(path) + ": " + as_string(file.errorString()));
+
+		auto heap_bytes = heap.size() * sizeof(char16_t);
+		bool ok = file.write(data.data(), data.size()) == static_cast<qint64>(data.size())
+		      and file.write(reinterpret_cast<const char *>(heap.data()), heap_bytes) == static_cast<qint64>(heap_bytes)
+		      and file.commit();
+
+		if (not ok)
+			throw std::runtime_error("failed to write " + as_string(path) + ": " + as_string(file.errorString()));
+	}
+
+	/************************************************************************/
+	/*                   torrent_snapshot                                   */
+	/************************************************************************/
+	void torrent_snapshot::validate_and_index()
+	{
+		auto invalid = [this](const char * what)
+		{
+			throw std::runtime_error("invalid torrent snapshot " + as_string(m_file.fileName()) + ": " + what);
+		};
+
+		auto in_bounds = [this](std::uint64_t offset, std::uint64_t size)
+		{
+			return offset <= m_size and size <= m_size - offset and offset % 8 == 0;
+		};
+
+		if (m_size < sizeof(snapshot::header)) invalid("file is too small");
+
+		m_header = reinterpret_cast<const snapshot::header *>(m_data);
+		if (std::memcmp(m_header->magic, snapshot::magic, sizeof(snapshot::magic)) != 0) invalid("bad magic");
+		if (m_header->version != snapshot::version) invalid("unsupported version");
+
+		auto count = m_header->torrent_count;
+		if (count > m_size / sizeof(std::uint64_t)) invalid("bad torrent count");
+		if (not in_bounds(m_header->fields_offset, std::uint64_t(m_header->field_count) * sizeof(snapshot::field_entry))) invalid("bad field table");
+		if (m_header->heap_size > m_size / sizeof(char16_t) or not in_bounds(m_header->heap_offset, m_header->heap_size * sizeof(char16_t))) invalid("bad string heap");
+
+		m_heap = reinterpret_cast<const char16_t *>(m_data + m_header->heap_offset);
+
+		// stored fields are matched with current ones by name
+		auto & meta = default_torrent_meta();
+		std::unordered_map<QString, index_type> keys;
+		for (index_type key = 0; key < torrent::LastField; ++key)
+			keys.emplace(meta.item_name(key), key);
+
+		m_columns.assign(torrent::LastField, column());
+
+		auto * entries = reinterpret_cast<const snapshot::field_entry *>(m_data + m_header->fields_offset);
+		for (std::uint32_t i = 0; i < m_header->field_count; ++i)
+		{
+			auto & entry = entries[i];
+			if (std::uint64_t(entry.name_offset) + entry.name_length > m_header->heap_size) invalid("bad field name");
+			if (not in_bounds(entry.values_offset, count * sizeof(std::uint64_t))) invalid("bad field values");
+			if (not in_bounds(entry.presence_offset, presence_words(count) * sizeof(std::uint64_t))) invalid("bad field presence");
+
+			auto name = QString::fromRawData(reinterpret_cast<const QChar *>(m_heap + entry.name_offset), entry.name_length);
+			auto it = keys.find(name);
+			// field was removed or changed type since snapshot was written - skip it
+			if (it == keys.end() or meta.item_type(it->second) != entry.type) continue;
+
+			auto & col = m_columns[it->second];
+			col.type = entry.type;
+			col.values = reinterpret_cast<const std::uint64_t *>(m_data + entry.values_offset);
+			col.presence = reinterpret_cast<const std::uint64_t *>(m_data + entry.presence_offset);
+		}
+	}
+
+	auto torrent_snapshot::raw(std::size_t row, index_type key) const noexcept -> const std::uint64_t *
+	{
+		assert(row < size());
+		if (not has_field(key)) return nullptr;
+
+		auto & col = m_columns[key];
+		if (not (col.presence[row / 64] >> (row % 64) & 1)) return nullptr;
+
+		return col.values + row;
+	}
+
+	auto torrent_snapshot::get_string(std::size_t row, index_type key) const -> optional<QString>
+	{
+		auto * ptr = raw(row, key);
+		if (not ptr) return nullopt;
+
+		snapshot::string_ref ref;
+		std::memcpy(&ref, ptr, sizeof(ref));
+		if (std::uint64_t(ref.offset) + ref.length > m_header->heap_size) return nullopt;
+
+		return QString::fromRawData(reinterpret_cast<const QChar *>(m_heap + ref.offset), ref.length);
+	}
+
+	auto torrent_snapshot::to_torrent(std::size_t row) const -> torrent
+	{
+		torrent torr;
+		for (index_type key = 0; key < m_columns.size(); ++key)
+		{
+			if (not has_field(key)) continue;
+
+			switch (m_columns[key].type)
+			{
+				case model_meta::Speed:
+				case model_meta::Size:
+				case model_meta::Uint64:
+					if (auto val = get<uint64_type>(row, key)) torr.set_item(key, *val);
+					break;
+
+				case model_meta::Int64:
+					if (auto val = get<int64_type>(row, key)) torr.set_item(key, *val);
+					break;
+
+				case model_meta::Bool:
+					if (auto val = get<std::uint64_t>(row, key)) torr.set_item(key, *val != 0);
+					break;
+
+				case model_meta::Ratio:
+				case model_meta::Percent:
+				case model_meta::Double:
+					if (auto val = get<double>(row, key)) torr.set_item(key, *val);
+					break;
+
+				case model_meta::DateTime:
+					if (auto val = get<datetime_type>(row, key)) torr.set_item(key, *val);
+					break;
+
+				case model_meta::Duration:
+					if (auto val = get<duration_type>(row, key)) torr.set_item(key, *val);
+					break;
+
+				case model_meta::String:
+					// deep copy, torrent outlives mapping
+					if (auto val = get_string(row, key)) torr.set_item(key, QString(val->constData(), val->size()));
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		return torr;
+	}
+
+	auto torrent_snapshot::to_torrent_list() const -> torrent_list
+	{
+		QTOR_TRACE_SCOPE("torrent_snapshot::to_torrent_list");
+
+		torrent_list result;
+		result.reserve(size());
+
+		for (std::size_t row = 0; row < size(); ++row)
+			result.push_back(to_torrent(row));
+
+		return result;
+	}
+
+	torrent_snapshot::torrent_snapshot(const QString & path)
+		: m_file(path)
+	{
+		if (not m_file.open(QIODevice::ReadOnly))
+			throw std::runtime_error("failed to open " + as_string(path) + ": " + as_string(m_file.errorString()));
+
+		m_size = static_cast<std::size_t>(m_file.size());
+		m_data = m_size ? m_file.map(0, m_file.size()) : nullptr;
+		if (m_size and not m_data)
+			throw std::runtime_error("failed to map " + as_string(path) + ": " + as_string(m_file.errorString()));
+
+		validate_and_index();
+	}
+}
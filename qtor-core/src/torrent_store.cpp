@@ -1,16 +1,68 @@
 #include <qtor/torrent_store.hpp>
+#include <qtor/update_scheduler.hpp>
 
 namespace qtor
 {
 	auto torrent_store::subscribe() -> ext::net::subscription_handle
 	{
-		auto handler = [this](auto recs) { assign_records(std::move(recs)); };
+		// subscription delivers full snapshots, only latest one within frame is applied.
+		// Snapshot is only read, source may keep it for next emission(see multi_data_source):
+		// it is compared with store right away and only torrents differing from stored ones are copied
+		auto handler = [this](torrent_list & recs)
+		{
+			if (m_pending_snapshot)
+				metrics::pipeline().snapshots_coalesced.add();
+
+			pending_snapshot pending;
+			pending.ids.reserve(recs.size());
+			for (const auto & rec : recs)
+			{
+				pending.ids.push_back(rec.id());
+
+				auto it = find(rec.id());
+				if (it == end() or changed_fields(*it, rec))
+					pending.changed.push_back(rec);
+				else
+					++pending.unchanged;
+			}
+
+			m_pending_snapshot = std::move(pending);
+			update_scheduler::instance().post(this, [this] { flush_pending(); });
+		};
+
 		return m_source->subscribe_torrents(handler);
 	}
 
+	void torrent_store::flush_pending()
+	{
+		if (not m_pending_snapshot) return;
+
+		auto snapshot = std::move(*m_pending_snapshot);
+		m_pending_snapshot.reset();
+
+		bool first = m_generation == 0;
+		metrics::pipeline().upsert_unchanged.add(snapshot.unchanged);
+		reconcile_records(snapshot.ids, std::move(snapshot.changed));
+
+		// time to first live data, compare with startup_first_paint_ms for warm start effect
+		if (first)
+			metrics::pipeline().startup_first_live_ms.set(tracing::now() / 1000000);
+	}
+
+	auto torrent_store::last_changed_fields(torrent_id_type id) const -> field_mask
+	{
+		auto it = m_changed.find(id);
+		return it == m_changed.end() ? 0 : it->second;
+	}
+
 	torrent_store::torrent_store(std::shared_ptr<abstract_data_source> source)
-		: m_source(std::move(source)) 
+		: m_source(std::move(source))
 	{
 
 	}
+
+	torrent_store::~torrent_store()
+	{
+		update_scheduler::instance().cancel(this);
+	}
 }
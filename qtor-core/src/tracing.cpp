@@ -0,0 +1,204 @@
+#include <qtor/tracing.hpp>
+
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <fmt/format.h>
+
+namespace qtor::tracing
+{
+	std::atomic<bool> g_enabled = false;
+
+	static const auto trace_epoch = std::chrono::steady_clock::now();
+
+	/// Ring of recorded spans of one thread. Only owning thread writes,
+	/// exporter reads concurrently, slots are atomic, so torn events are detected by sequence number.
+	class trace_ring
+	{
+	public:
+		static constexpr std::size_t capacity = 1 << 15;
+
+		struct slot
+		{
+			std::atomic<std::uint64_t> seq {0}; // 1-based sequence number of event in slot, 0 - empty
+			std::atomic<const char *> name {nullptr};
+			std::atomic<std::int64_t> start {0};
+			std::atomic<std::int64_t> end {0};
+		};
+
+		struct event
+		{
+			const char * name;
+			std::int64_t start, end;
+		};
+
+	private:
+		std::unique_ptr<slot[]> m_slots = std::make_unique<slot[]>(capacity);
+		std::atomic<std::uint64_t> m_head = 0;
+		std::atomic<std::uint64_t> m_cleared = 0; // events before this sequence number are dropped
+
+	public:
+		unsigned tid;
+		std::string thread_name;
+
+	public:
+		void push(const char * name, std::int64_t start, std::int64_t end) noexcept;
+		void read(std::vector<event> & events) const;
+		void clear() noexcept { m_cleared.store(m_head.load(std::memory_order_acquire), std::memory_order_relaxed); }
+	};
+
+	void trace_ring::push(const char * name, std::int64_t start, std::int64_t end) noexcept
+	{
+		auto seq = m_head.load(std::memory_order_relaxed) + 1;
+		auto & s = m_slots[seq % capacity];
+
+		// invalidate slot first, so reader does not mix old and new events
+		s.seq.store(0, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		s.name.store(name, std::memory_order_relaxed);
+		s.start.store(start, std::memory_order_relaxed);
+		s.end.store(end, std::memory_order_relaxed);
+		s.seq.store(seq, std::memory_order_release);
+
+		m_head.store(seq, std::memory_order_release);
+	}
+
+	void trace_ring::read(std::vector<event> & events) const
+	{
+		auto head = m_head.load(std::memory_order_acquire);
+		auto first = std::max(m_cleared.load(std::memory_order_relaxed), head > capacity ? head - capacity : 0) + 1;
+
+		for (auto seq = first; seq <= head; ++seq)
+		{
+			auto & s = m_slots[seq % capacity];
+			if (s.seq.load(std::memory_order_acquire) != seq) continue;
+
+			event ev;
+			ev.name = s.name.load(std::memory_order_relaxed);
+			ev.start = s.start.load(std::memory_order_relaxed);
+			ev.end = s.end.load(std::memory_order_relaxed);
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (s.seq.load(std::memory_order_relaxed) != seq) continue; // overwritten while reading
+
+			events.push_back(ev);
+		}
+	}
+
+	/// all rings ever created, rings outlive their threads, so spans of finished threads are still exported
+	static std::mutex g_rings_mutex;
+	static std::vector<std::shared_ptr<trace_ring>> g_rings;
+
+	static trace_ring & thread_ring()
+	{
+		thread_local std::shared_ptr<trace_ring> ring = []
+		{
+			auto ring = std::make_shared<trace_ring>();
+
+			std::lock_guard lk(g_rings_mutex);
+			ring->tid = static_cast<unsigned>(g_rings.size() + 1);
+			g_rings.push_back(ring);
+			return ring;
+		}();
+
+		return *ring;
+	}
+
+	std::int64_t now() noexcept
+	{
+		using namespace std::chrono;
+		return duration_cast<nanoseconds>(steady_clock::now() - trace_epoch).count();
+	}
+
+	void enable(bool enable) noexcept
+	{
+		g_enabled.store(enable, std::memory_order_relaxed);
+	}
+
+	void record(const char * name, std::int64_t start, std::int64_t end) noexcept
+	{
+		thread_ring().push(name, start, end);
+	}
+
+	void set_thread_name(std::string name)
+	{
+		auto & ring = thread_ring();
+
+		std::lock_guard lk(g_rings_mutex);
+		ring.thread_name = std::move(name);
+	}
+
+	void clear()
+	{
+		std::lock_guard lk(g_rings_mutex);
+		for (auto & ring : g_rings)
+			ring->clear();
+	}
+
+	static void write_json_string(std::string & out, const char * str)
+	{
+		out += '"';
+		for (; *str; ++str)
+		{
+			switch (*str)
+			{
+				case '"':  out += "\\\""; break;
+				case '\\': out += "\\\\"; break;
+				default:
+					if (static_cast<unsigned char>(*str) < 0x20)
+						fmt::format_to(std::back_inserter(out), "\\u{:04x}", static_cast<unsigned>(*str));
+					else
+						out += *str;
+			}
+		}
+		out += '"';
+	}
+
+	std::string export_chrome_trace()
+	{
+		std::string out = R"({"displayTimeUnit":"ms","traceEvents":[)";
+		std::vector<trace_ring::event> events;
+		bool first = true;
+
+		auto separator = [&out, &first] { if (not first) out += ",\n"; first = false; };
+
+		std::lock_guard lk(g_rings_mutex);
+		for (auto & ring : g_rings)
+		{
+			if (not ring->thread_name.empty())
+			{
+				separator();
+				fmt::format_to(std::back_inserter(out), R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":)", ring->tid);
+				write_json_string(out, ring->thread_name.c_str());
+				out += "}}";
+			}
+
+			events.clear();
+			ring->read(events);
+
+			for (auto & ev : events)
+			{
+				separator();
+				out += R"({"name":)";
+				write_json_string(out, ev.name);
+				// timestamps are in microseconds
+				fmt::format_to(std::back_inserter(out), R"(,"ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+					ring->tid, ev.start / 1000.0, (ev.end - ev.start) / 1000.0);
+			}
+		}
+
+		out += "]}\n";
+		return out;
+	}
+
+	bool write_chrome_trace(const std::string & path)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << export_chrome_trace();
+		return static_cast<bool>(file.flush());
+	}
+}
@@ -0,0 +1,209 @@
+#include <qtor/transfer_history.hpp>
+#include <qtor/tracing.hpp>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace qtor
+{
+	// 1024 steps per octave, 64 octaves cover whole speed_type range
+	static constexpr double quantize_steps = 1024.0;
+
+	auto transfer_history::quantize(speed_type speed) noexcept -> sample_type
+	{
+		auto q = std::lround(std::log2(1.0 + static_cast<double>(speed)) * quantize_steps);
+		return static_cast<sample_type>(std::min<long>(q, std::numeric_limits<sample_type>::max()));
+	}
+
+	auto transfer_history::dequantize(sample_type sample) noexcept -> speed_type
+	{
+		return static_cast<speed_type>(std::llround(std::exp2(sample / quantize_steps) - 1.0));
+	}
+
+	auto transfer_history::tier_offset(direction_type dir, tier_type tier) noexcept -> unsigned
+	{
+		unsigned offset = dir * ms_samples_per_direction;
+		for (unsigned t = 0; t < tier; ++t)
+			offset += tier_capacity[t];
+
+		return offset;
+	}
+
+	auto transfer_history::acquire_slot(const torrent * ptr) -> unsigned
+	{
+		auto it = m_slots.find(ptr);
+		if (it != m_slots.end()) return it->second;
+
+		unsigned slot;
+		if (not m_free_slots.empty())
+		{
+			slot = m_free_slots.back();
+			m_free_slots.pop_back();
+		}
+		else
+		{
+			slot = static_cast<unsigned>(m_accumulators.size());
+			m_arena.resize(m_arena.size() + ms_slot_size);
+			m_accumulators.emplace_back();
+			m_born.emplace_back();
+		}
+
+		m_accumulators[slot] = accumulator();
+		m_born[slot] = m_pushed;
+		m_slots.emplace(ptr, slot);
+		return slot;
+	}
+
+	void transfer_history::release_slot(const torrent * ptr)
+	{
+		auto it = m_slots.find(ptr);
+		if (it == m_slots.end()) return;
+
+		m_free_slots.push_back(it->second);
+		m_slots.erase(it);
+	}
+
+	void transfer_history::release_all()
+	{
+		for (auto & [ptr, slot] : m_slots)
+			m_free_slots.push_back(slot);
+
+		m_slots.clear();
+	}
+
+	void transfer_history::push(tier_type tier, const std::vector<speed_sample> & speeds)
+	{
+		auto head = m_heads[tier];
+		auto next = static_cast<tier_type>(tier + 1);
+		bool cascade = next < tier_count;
+
+		for (unsigned slot = 0; slot < speeds.size(); ++slot)
+		{
+			auto * base = m_arena.data() + std::size_t(slot) * ms_slot_size;
+			auto & acc = m_accumulators[slot];
+
+			for (unsigned dir = 0; dir < direction_count; ++dir)
+			{
+				auto speed = speeds[slot][dir];
+				base[tier_offset(static_cast<direction_type>(dir), tier) + head] = quantize(static_cast<speed_type>(speed));
+				if (cascade) acc.sums[next][dir] += speed;
+			}
+		}
+
+		m_heads[tier] = (head + 1) % tier_capacity[tier];
+		++m_pushed[tier];
+
+		if (not cascade or m_pushed[tier] % tier_ratio[next]) return;
+
+		// coarser sample is average of finer ones
+		std::vector<speed_sample> averages(speeds.size());
+		for (unsigned slot = 0; slot < speeds.size(); ++slot)
+		{
+			auto & sums = m_accumulators[slot].sums[next];
+			for (unsigned dir = 0; dir < direction_count; ++dir)
+				averages[slot][dir] = sums[dir] / tier_ratio[next];
+
+			sums = {};
+		}
+
+		push(next, averages);
+	}
+
+	void transfer_history::sample(clock_type::time_point now /* = clock_type::now() */)
+	{
+		QTOR_TRACE_SCOPE("transfer_history::sample");
+
+		unsigned ticks = 1;
+		if (m_last_sample == clock_type::time_point())
+			m_last_sample = now;
+		else
+		{
+			auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - m_last_sample);
+			if (elapsed.count() <= 0) return;
+
+			m_last_sample += elapsed;
+			ticks = static_cast<unsigned>(std::min<std::chrono::seconds::rep>(elapsed.count(), tier_capacity[seconds]));
+		}
+
+		for (auto & torr : *m_store)
+			acquire_slot(&torr);
+
+		// free slots stay zero, total slot is sum of all others
+		std::vector<speed_sample> speeds(m_accumulators.size());
+		auto & total = speeds[ms_total_slot];
+
+		for (auto & [ptr, slot] : m_slots)
+		{
+			auto & speed = speeds[slot];
+			speed[download] = static_cast<float>(ptr->download_speed().value_or(0));
+			speed[upload] = static_cast<float>(ptr->upload_speed().value_or(0));
+
+			total[download] += speed[download];
+			total[upload] += speed[upload];
+		}
+
+		for (unsigned i = 0; i < ticks; ++i)
+			push(seconds, speeds);
+	}
+
+	auto transfer_history::read(unsigned slot, direction_type dir, tier_type tier) const -> std::vector<speed_type>
+	{
+		auto capacity = tier_capacity[tier];
+		auto valid = static_cast<unsigned>(std::min<std::uint64_t>(capacity, m_pushed[tier] - m_born[slot][tier]));
+		auto * ring = m_arena.data() + std::size_t(slot) * ms_slot_size + tier_offset(dir, tier);
+
+		std::vector<speed_type> result;
+		result.reserve(valid);
+
+		auto pos = (m_heads[tier] + capacity - valid) % capacity;
+		for (unsigned i = 0; i < valid; ++i, pos = (pos + 1) % capacity)
+			result.push_back(dequantize(ring[pos]));
+
+		return result;
+	}
+
+	auto transfer_history::history(torrent_id_type id, direction_type dir, tier_type tier) const -> std::vector<speed_type>
+	{
+		auto torr_it = m_store->find(id);
+		if (torr_it == m_store->end()) return {};
+
+		auto it = m_slots.find(&*torr_it);
+		if (it == m_slots.end()) return {};
+
+		return read(it->second, dir, tier);
+	}
+
+	auto transfer_history::total_history(direction_type dir, tier_type tier) const -> std::vector<speed_type>
+	{
+		return read(ms_total_slot, dir, tier);
+	}
+
+	auto transfer_history::memory_usage() const noexcept -> std::size_t
+	{
+		return m_arena.capacity() * sizeof(sample_type)
+			+ m_accumulators.capacity() * sizeof(accumulator)
+			+ m_born.capacity() * sizeof(m_born[0])
+			+ m_free_slots.capacity() * sizeof(unsigned)
+			+ m_slots.size() * (sizeof(const torrent *) + sizeof(unsigned) + 2 * sizeof(void *));
+	}
+
+	transfer_history::transfer_history(std::shared_ptr<torrent_store> store)
+		: m_store(std::move(store))
+	{
+		// total slot, never released
+		m_arena.resize(ms_slot_size);
+		m_accumulators.emplace_back();
+		m_born.emplace_back();
+
+		m_update_conn = m_store->on_update([this](const auto & erased, const auto & updated, const auto & inserted)
+		{
+			for (const torrent * ptr : erased)
+				release_slot(ptr);
+
+			sample();
+		});
+
+		m_erase_conn = m_store->on_erase([this](const auto & erased) { for (const torrent * ptr : erased) release_slot(ptr); });
+		m_clear_conn = m_store->on_clear([this] { release_all(); });
+	}
+}
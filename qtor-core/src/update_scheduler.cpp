@@ -0,0 +1,87 @@
+#include <qtor/update_scheduler.hpp>
+#include <qtor/tracing.hpp>
+#include <utility>
+#include <algorithm>
+
+namespace qtor
+{
+	bool update_scheduler::post(key_type key, action_type action)
+	{
+		auto it = std::find_if(m_pending.begin(), m_pending.end(), [key](auto & item) { return item.first == key; });
+		if (it != m_pending.end())
+		{
+			it->second = std::move(action);
+			return false;
+		}
+
+		m_pending.emplace_back(key, std::move(action));
+		if (m_timer.isActive()) return true;
+
+		// flush right away if last one was at least frame ago, otherwise wait until frame passes
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_last_flush);
+		auto delay = std::max(m_frame_interval - elapsed, std::chrono::milliseconds::zero());
+		m_timer.start(static_cast<int>(delay.count()));
+
+		return true;
+	}
+
+	void update_scheduler::cancel(key_type key)
+	{
+		auto it = std::remove_if(m_pending.begin(), m_pending.end(), [key](auto & item) { return item.first == key; });
+		m_pending.erase(it, m_pending.end());
+
+		if (m_pending.empty())
+			m_timer.stop();
+
+		// store destroyed by earlier action of running batch, it's own action must not run
+		if (m_running)
+		{
+			for (auto & item : *m_running)
+				if (item.first == key) item.second = nullptr;
+		}
+	}
+
+	void update_scheduler::flush()
+	{
+		QTOR_TRACE_SCOPE("update_scheduler::flush");
+
+		m_timer.stop();
+		m_last_flush = std::chrono::steady_clock::now();
+
+		// actions can post new ones, those go to next frame
+		auto pending = std::move(m_pending);
+		m_pending.clear();
+
+		auto * prev_running = std::exchange(m_running, &pending);
+		try
+		{
+			for (auto & item : pending)
+			{
+				// actions can cancel ones following them, see cancel
+				auto action = std::move(item.second);
+				item.second = nullptr;
+				if (action) action();
+			}
+		}
+		catch (...)
+		{
+			m_running = prev_running;
+			throw;
+		}
+
+		m_running = prev_running;
+	}
+
+	update_scheduler & update_scheduler::instance()
+	{
+		static update_scheduler instance;
+		return instance;
+	}
+
+	update_scheduler::update_scheduler()
+	{
+		m_timer.setSingleShot(true);
+		m_timer.setTimerType(Qt::PreciseTimer);
+		QObject::connect(&m_timer, &QTimer::timeout, [this] { flush(); });
+	}
+}
@@ -5,7 +5,7 @@ namespace qtor
 	void view_manager::start_subscription()
 	{
 		if (not m_subsription_handle)
-			subscribe();
+			m_subsription_handle = subscribe();
 		else
 			m_subsription_handle.resume();
 	}
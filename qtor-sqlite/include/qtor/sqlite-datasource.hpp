@@ -77,8 +77,14 @@ namespace qtor::sqlite
 
 	public:
 		virtual ext::future<torrent_file_list> get_torrent_files(torrent_id_type id) override;
+		virtual ext::future<torrent_file_map> get_torrent_files(torrent_id_list ids) override;
 		virtual ext::future<torrent_peer_list> get_torrent_peers(torrent_id_type id) override { return ext::make_ready_future<torrent_peer_list>({}); }
 
+		virtual ext::future<torrent_detail> get_torrent_detail(torrent_id_type id) override;
+		virtual auto subscribe_torrent_detail(torrent_id_type id, torrent_detail_handler handler) -> ext::net::subscription_handle override { return {}; }
+		virtual auto subscribe_torrent_peers(torrent_id_type id, torrent_peer_handler handler) -> ext::net::subscription_handle override { return {}; }
+		virtual auto subscribe_torrent_files(torrent_id_type id, torrent_file_handler handler) -> ext::net::subscription_handle override { return {}; }
+
 	public:
 		virtual std::string last_errormsg() const override { return ""; }
 
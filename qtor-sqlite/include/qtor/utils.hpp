@@ -10,6 +10,7 @@ namespace qtor
 {
 	using types_variant = variant<
 		uint64_type,
+		int64_type,
 		bool,
 		double,
 		string_type,
@@ -82,6 +82,30 @@ namespace qtor::sqlite
 		return ext::make_ready_future(std::move(files));
 	}
 
+	auto sqlite_datasource::get_torrent_files(torrent_id_list ids) -> ext::future<torrent_file_map>
+	{
+		assert(m_ses);
+		auto & ses = *static_cast<sqlite3yaw::session *>(m_ses);
+
+		torrent_file_map result;
+		for (auto & id : ids)
+			result.insert_or_assign(id, load_torrent_files(ses, id));
+
+		return ext::make_ready_future(std::move(result));
+	}
+
+	auto sqlite_datasource::get_torrent_detail(torrent_id_type id) -> ext::future<torrent_detail>
+	{
+		assert(m_ses);
+
+		// only files are stored in database
+		torrent_detail detail;
+		detail.files = load_torrent_files(*static_cast<sqlite3yaw::session *>(m_ses), id);
+		detail.id = std::move(id);
+
+		return ext::make_ready_future(std::move(detail));
+	}
+
 	sqlite_datasource::sqlite_datasource()
 	{
 		using namespace std;
@@ -30,6 +30,7 @@ namespace qtor::sqlite
 		{
 			case model_meta::Speed:
 			case model_meta::Size:
+			case model_meta::Int64:
 			case model_meta::Uint64: return "INT";
 			case model_meta::Double: return "REAL";
 			case model_meta::String: return "TEXT";
@@ -116,7 +117,7 @@ namespace qtor::sqlite
 	void create_torrent_files_table(sqlite3yaw::session & ses)
 	{
 		auto meta = make_torrent_file_meta();
-		meta.push_item("torrent_id", meta.String, "");
+		meta.push_item("torrent_id", meta.Int64, make_any(torrent_id_type()));
 		return create_table(ses, torrent_files_table_name, meta);
 	}
 
@@ -145,39 +146,46 @@ namespace qtor::sqlite
 		torrent torr;
 		//conv_type conv {stmt, torr};
 
+		// meta can miss fields absent in table(saved by older version), so column is position in meta, not field index
+		unsigned column = 0;
 		for (auto & info : meta)
 		{ 
 			unsigned key  = info.index;
 			unsigned type = info.type;
+			unsigned col  = column++;
 
 			switch (type)
 			{
 				case model_meta::Uint64:
 				case model_meta::Speed:
 				case model_meta::Size:
-					torr.set_item(key, sqlite3yaw::get<optional<uint64_type>>(stmt, key));
+					torr.set_item(key, sqlite3yaw::get<optional<uint64_type>>(stmt, col));
+					break;
+
+				case model_meta::Int64:
+					torr.set_item(key, sqlite3yaw::get<optional<int64_type>>(stmt, col));
 					break;
 
 				case model_meta::Bool:
-					torr.set_item(key, sqlite3yaw::get<optional<bool>>(stmt, key));
+					torr.set_item(key, sqlite3yaw::get<optional<bool>>(stmt, col));
 					break;
 
 				case model_meta::Double:
 				case model_meta::Percent:
 				case model_meta::Ratio:
-					torr.set_item(key, sqlite3yaw::get<optional<double>>(stmt, key));
+					torr.set_item(key, sqlite3yaw::get<optional<double>>(stmt, col));
 					break;
 
 				case model_meta::String:
-					torr.set_item(key, sqlite3yaw::get<optional<string_type>>(stmt, key));
+					torr.set_item(key, sqlite3yaw::get<optional<string_type>>(stmt, col));
 					break;
 
 				case model_meta::DateTime:
-					torr.set_item(key, sqlite3yaw::get<optional<datetime_type>>(stmt, key));
+					torr.set_item(key, sqlite3yaw::get<optional<datetime_type>>(stmt, col));
 					break;
 
 				case model_meta::Duration:
-					torr.set_item(key, sqlite3yaw::get<optional<duration_type>>(stmt, key));
+					torr.set_item(key, sqlite3yaw::get<optional<duration_type>>(stmt, col));
 					break;
 
 				default:
@@ -215,7 +223,7 @@ namespace qtor::sqlite
 	{
 		auto tmeta = sqlite3yaw::load_table_meta(ses, torrent_files_table_name);
 		auto meta = make_torrent_file_meta();
-		meta.push_item("torrent_id", meta.String, id);
+		meta.push_item("torrent_id", meta.Int64, make_any(id));
 
 		auto field_info = create_info(meta);
 		auto names = field_info | boost::adaptors::transformed(std::mem_fn(&field_info::name));
@@ -15,6 +15,12 @@ namespace qtor
 				else
 					return nullopt;
 
+			case model_meta::Int64:
+				if (auto * ptr = any_cast<int64_type>(&val))
+					return *ptr;
+				else
+					return nullopt;
+
 			case model_meta::Bool:
 				if (auto * ptr = any_cast<bool>(&val))
 					return *ptr;
@@ -0,0 +1,2 @@
+#define BOOST_TEST_MODULE qtor tests
+#include <boost/test/unit_test.hpp>
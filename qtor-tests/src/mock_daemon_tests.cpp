@@ -0,0 +1,102 @@
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include <qtor/transmission/requests.hpp>
+#include "mock_daemon.hpp"
+
+namespace
+{
+	auto count_of(const std::string & str, const std::string & what)
+	{
+		std::size_t count = 0;
+		for (auto pos = str.find(what); pos != std::string::npos; pos = str.find(what, pos + what.size()))
+			++count;
+
+		return count;
+	}
+
+	auto torrent_get_body(int first, int last)
+	{
+		std::string body = R"({"method":"torrent-get","arguments":{"fields":["id","name"],"ids":[)";
+		for (int id = first; id <= last; ++id)
+		{
+			if (id != first) body += ", ";
+			body += std::to_string(id);
+		}
+
+		body += "]}}";
+		return body;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(mock_daemon_tests)
+
+BOOST_AUTO_TEST_CASE(torrent_get_many_ids)
+{
+	qtor::mock::mock_options options;
+	options.torrents = 10000;
+	qtor::mock::mock_daemon daemon(options);
+
+	auto response = daemon.handle(torrent_get_body(1, 8000));
+	BOOST_CHECK_EQUAL(count_of(response, R"("id":)"), 8000);
+	BOOST_CHECK(response.find(R"("result":"success")") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(torrent_get_all)
+{
+	qtor::mock::mock_options options;
+	options.torrents = 100;
+	qtor::mock::mock_daemon daemon(options);
+
+	// no ids - all torrents, keys inside strings are not taken for members
+	auto response = daemon.handle(R"({ "method" : "torrent-get", "tag" : "\"ids\":[1]", "arguments" : { "fields" : [ "id" ] } })");
+	BOOST_CHECK_EQUAL(count_of(response, R"("id":)"), 100);
+}
+
+BOOST_AUTO_TEST_CASE(torrent_remove_many_ids)
+{
+	qtor::mock::mock_options options;
+	options.torrents = 10000;
+	qtor::mock::mock_daemon daemon(options);
+
+	auto body = torrent_get_body(1, 9000);
+	body.replace(body.find("torrent-get"), std::size("torrent-get") - 1, "torrent-remove");
+	daemon.handle(body);
+
+	auto response = daemon.handle(R"({"method":"torrent-get","arguments":{"fields":["id"]}})");
+	BOOST_CHECK_EQUAL(count_of(response, R"("id":)"), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(torrent_remove_command)
+{
+	qtor::mock::mock_options options;
+	options.torrents = 10;
+	qtor::mock::mock_daemon daemon(options);
+
+	qtor::transmission::request_buffer out;
+	auto ids = {qtor::torrent_id_type(2), qtor::torrent_id_type(5)};
+	qtor::transmission::make_action_command(out, qtor::transmission::rpc_method::torrent_remove, ids, qtor::transmission::make_torrent_remove_arguments(true));
+
+	auto command = fmt::to_string(out);
+	BOOST_CHECK_EQUAL(command, R"({ "method": "torrent-remove", "arguments": { "ids": [ 2, 5 ], "delete-local-data": true } })");
+
+	auto response = daemon.handle(command);
+	BOOST_CHECK(response.find(R"("result":"success")") != std::string::npos);
+
+	response = daemon.handle(R"({"method":"torrent-get","arguments":{"fields":["id"]}})");
+	BOOST_CHECK_EQUAL(count_of(response, R"("id":)"), 8);
+}
+
+BOOST_AUTO_TEST_CASE(torrent_set_location_arguments)
+{
+	auto arguments = qtor::transmission::make_torrent_set_location_arguments(R"(/data/"new" dir)", true);
+	BOOST_CHECK_EQUAL(arguments, R"("location": "/data/\"new\" dir", "move": true)");
+}
+
+BOOST_AUTO_TEST_CASE(unknown_method)
+{
+	qtor::mock::mock_daemon daemon(qtor::mock::mock_options {});
+	auto response = daemon.handle(R"({"method":"no-such-method"})");
+	BOOST_CHECK(response.find("method name not recognized") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
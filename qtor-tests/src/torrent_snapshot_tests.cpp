@@ -0,0 +1,273 @@
+#include <cstring>
+#include <stdexcept>
+#include <boost/test/unit_test.hpp>
+
+#include <QtCore/QFile>
+#include <QtCore/QByteArray>
+#include <QtCore/QTemporaryDir>
+
+#include <qtor/torrent.hpp>
+#include <qtor/torrent_snapshot.hpp>
+
+namespace
+{
+	using namespace qtor;
+	namespace snapshot = torrent_snapshot_format;
+
+	auto make_torrent(torrent_id_type id) -> torrent
+	{
+		using namespace std::chrono;
+		auto date = system_clock::time_point(seconds(1500000000 + id));
+
+		torrent torr;
+		torr.id(id);
+		torr.name(QStringLiteral("torrent %1").arg(id));
+		torr.hash_string(QStringLiteral("%1").arg(id, 40, 16, QLatin1Char('0')));
+		torr.status(id % 7);
+		torr.ratio(id / 3.0);
+		torr.total_size(id * 1024 * 1024);
+		torr.current_size(id * 1024);
+		torr.download_speed(id * 10);
+		torr.eta(seconds(id * 60));
+		torr.date_added(date);
+
+		// optional fields are missing in every other torrent
+		if (id % 2)
+		{
+			torr.comment(QStringLiteral("comment %1").arg(id));
+			torr.upload_speed(id);
+			torr.date_done(date + hours(1));
+		}
+
+		return torr;
+	}
+
+	auto make_torrents(std::size_t count) -> torrent_list
+	{
+		torrent_list torrents;
+		for (std::size_t i = 0; i < count; ++i)
+			torrents.push_back(make_torrent(static_cast<torrent_id_type>(i + 1)));
+
+		return torrents;
+	}
+
+	void check_equal(const torrent_list & expected, const torrent_list & loaded)
+	{
+		BOOST_REQUIRE_EQUAL(expected.size(), loaded.size());
+		for (std::size_t i = 0; i < expected.size(); ++i)
+			BOOST_CHECK_MESSAGE(changed_fields(expected[i], loaded[i]) == 0, "torrent " << expected[i].id() << " differs");
+	}
+
+	auto read_file(const QString & path) -> QByteArray
+	{
+		QFile file(path);
+		BOOST_REQUIRE(file.open(QIODevice::ReadOnly));
+		return file.readAll();
+	}
+
+	void write_file(const QString & path, const QByteArray & data)
+	{
+		QFile file(path);
+		BOOST_REQUIRE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+		BOOST_REQUIRE_EQUAL(file.write(data), data.size());
+	}
+
+	auto header_of(QByteArray & data) -> snapshot::header &
+	{
+		BOOST_REQUIRE(static_cast<std::size_t>(data.size()) >= sizeof(snapshot::header));
+		return *reinterpret_cast<snapshot::header *>(data.data());
+	}
+
+	/// field table entry of field with given name
+	auto field_of(QByteArray & data, const QString & name) -> snapshot::field_entry &
+	{
+		auto & header = header_of(data);
+		auto * entries = reinterpret_cast<snapshot::field_entry *>(data.data() + header.fields_offset);
+		auto * heap = reinterpret_cast<const QChar *>(data.constData() + header.heap_offset);
+
+		for (std::uint32_t i = 0; i < header.field_count; ++i)
+			if (QString(heap + entries[i].name_offset, entries[i].name_length) == name)
+				return entries[i];
+
+		BOOST_FAIL("field is not found in snapshot");
+		throw std::logic_error("unreachable");
+	}
+
+	struct snapshot_fixture
+	{
+		QTemporaryDir dir;
+		QString path = dir.filePath(QStringLiteral("torrents.snapshot"));
+	};
+}
+
+BOOST_FIXTURE_TEST_SUITE(torrent_snapshot_tests, snapshot_fixture)
+
+BOOST_AUTO_TEST_CASE(roundtrip)
+{
+	// more than one presence bitmap word
+	auto torrents = make_torrents(130);
+	write_torrent_snapshot(path, torrents);
+
+	torrent_snapshot snap(path);
+	BOOST_CHECK_EQUAL(snap.size(), torrents.size());
+	check_equal(torrents, snap.to_torrent_list());
+
+	// zero copy access
+	BOOST_CHECK(snap.get<size_type>(2, torrent::TotalSize) == torrents[2].total_size());
+	BOOST_CHECK(snap.get_string(2, torrent::Name) == torrents[2].name());
+	BOOST_CHECK(not snap.get_string(1, torrent::Comment));
+	BOOST_CHECK(snap.get_string(0, torrent::Comment) == torrents[0].comment());
+}
+
+BOOST_AUTO_TEST_CASE(empty_list)
+{
+	write_torrent_snapshot(path, {});
+
+	torrent_snapshot snap(path);
+	BOOST_CHECK_EQUAL(snap.size(), 0u);
+	BOOST_CHECK(snap.to_torrent_list().empty());
+	BOOST_CHECK(snap.has_field(torrent::Name));
+}
+
+BOOST_AUTO_TEST_CASE(string_limits)
+{
+	torrent_list torrents(4);
+	for (std::size_t i = 0; i < torrents.size(); ++i)
+		torrents[i].id(static_cast<torrent_id_type>(i + 1)).status(0);
+
+	torrents[0].name(QString());
+	torrents[1].name(QString(100000, QLatin1Char('x')));
+	// surrogate pairs and embedded zero are stored as raw UTF-16 code units
+	torrents[2].name(QString::fromUtf8("\xF0\x9F\x98\x80 \xD1\x82\xD0\xBE\xD1\x80\xD1\x80\xD0\xB5\xD0\xBD\xD1\x82"));
+	torrents[3].name(QString(QLatin1Char('a')).append(QChar(0)).append(QLatin1Char('b')).append(QChar(0xFFFF)));
+
+	write_torrent_snapshot(path, torrents);
+	torrent_snapshot snap(path);
+	check_equal(torrents, snap.to_torrent_list());
+
+	BOOST_CHECK_EQUAL(snap.get_string(0, torrent::Name)->size(), 0);
+	BOOST_CHECK_EQUAL(snap.get_string(1, torrent::Name)->size(), 100000);
+	BOOST_CHECK_EQUAL(snap.get_string(3, torrent::Name)->size(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(missing_file)
+{
+	BOOST_CHECK_THROW(torrent_snapshot snap(dir.filePath(QStringLiteral("absent.snapshot"))), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(empty_file)
+{
+	write_file(path, {});
+	BOOST_CHECK_THROW(torrent_snapshot snap(path), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(bad_magic)
+{
+	write_torrent_snapshot(path, make_torrents(10));
+	auto data = read_file(path);
+	header_of(data).magic[0] = 'X';
+	write_file(path, data);
+
+	BOOST_CHECK_THROW(torrent_snapshot snap(path), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(bad_version)
+{
+	write_torrent_snapshot(path, make_torrents(10));
+	auto data = read_file(path);
+	header_of(data).version = snapshot::version + 1;
+	write_file(path, data);
+
+	BOOST_CHECK_THROW(torrent_snapshot snap(path), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(truncated)
+{
+	write_torrent_snapshot(path, make_torrents(10));
+	auto data = read_file(path);
+	auto & header = header_of(data);
+
+	// cut inside header, field table, columns and string heap
+	std::size_t cuts[] = {
+		sizeof(snapshot::header) / 2,
+		header.fields_offset + sizeof(snapshot::field_entry) / 2,
+		header.fields_offset + header.field_count * sizeof(snapshot::field_entry) + 8,
+		header.heap_offset + 2,
+		static_cast<std::size_t>(data.size()) - 2,
+	};
+
+	for (auto cut : cuts)
+	{
+		write_file(path, data.left(static_cast<int>(cut)));
+		BOOST_CHECK_THROW(torrent_snapshot snap(path), std::runtime_error);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(corrupted_offsets)
+{
+	write_torrent_snapshot(path, make_torrents(10));
+	auto original = read_file(path);
+
+	auto data = original;
+	header_of(data).torrent_count = std::uint64_t(1) << 40;
+	write_file(path, data);
+	BOOST_CHECK_THROW(torrent_snapshot snap(path), std::runtime_error);
+
+	data = original;
+	header_of(data).heap_size += 1;
+	write_file(path, data);
+	BOOST_CHECK_THROW(torrent_snapshot snap(path), std::runtime_error);
+
+	data = original;
+	field_of(data, default_torrent_meta().item_name(torrent::Name)).values_offset = data.size();
+	write_file(path, data);
+	BOOST_CHECK_THROW(torrent_snapshot snap(path), std::runtime_error);
+
+	data = original;
+	field_of(data, default_torrent_meta().item_name(torrent::Name)).name_length = 0xFFFF;
+	write_file(path, data);
+	BOOST_CHECK_THROW(torrent_snapshot snap(path), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(field_type_mismatch)
+{
+	auto torrents = make_torrents(10);
+	write_torrent_snapshot(path, torrents);
+
+	// field changed type since snapshot was written: it is skipped, others are read
+	auto data = read_file(path);
+	field_of(data, default_torrent_meta().item_name(torrent::TotalSize)).type = model_meta::String;
+	write_file(path, data);
+
+	torrent_snapshot snap(path);
+	BOOST_CHECK(not snap.has_field(torrent::TotalSize));
+	BOOST_CHECK(not snap.get<size_type>(0, torrent::TotalSize));
+
+	for (auto & torr : torrents)
+		torr.remove_item(torrent::TotalSize);
+
+	check_equal(torrents, snap.to_torrent_list());
+}
+
+BOOST_AUTO_TEST_CASE(unknown_field)
+{
+	auto torrents = make_torrents(10);
+	write_torrent_snapshot(path, torrents);
+
+	// field written by other version, current torrent has no field with such name
+	auto data = read_file(path);
+	auto & entry = field_of(data, default_torrent_meta().item_name(torrent::Comment));
+	auto * name = reinterpret_cast<QChar *>(data.data() + header_of(data).heap_offset) + entry.name_offset;
+	name[0] = QLatin1Char('#');
+	write_file(path, data);
+
+	torrent_snapshot snap(path);
+	BOOST_CHECK(not snap.has_field(torrent::Comment));
+
+	for (auto & torr : torrents)
+		torr.remove_item(torrent::Comment);
+
+	check_equal(torrents, snap.to_torrent_list());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+#include <vector>
+#include <utility>
+#include <boost/test/unit_test.hpp>
+
+#include <qtor/torrent_store.hpp>
+#include <qtor/TorrentsModel.hpp>
+#include <qtor/transmission/replay_data_source.hpp>
+
+namespace
+{
+	using namespace qtor;
+
+	auto make_torrents(int count) -> torrent_list
+	{
+		torrent_list torrents;
+		for (int id = 1; id <= count; ++id)
+		{
+			torrent torr;
+			torr.id(id);
+			torr.name(QStringLiteral("torrent %1").arg(id));
+			torr.status(torrent_status::downloading);
+			torr.download_speed(id * 1024);
+			torrents.push_back(std::move(torr));
+		}
+
+		return torrents;
+	}
+
+	struct model_fixture
+	{
+		// replay source without recording never emits anything, it only satisfies store subscription
+		std::shared_ptr<torrent_store> store = std::make_shared<torrent_store>(std::make_shared<transmission::replay_data_source>());
+		std::shared_ptr<TorrentsModel> model;
+		std::vector<std::pair<QModelIndex, QModelIndex>> changes;
+
+		model_fixture()
+		{
+			store->assign_records(make_torrents(10));
+			model = std::make_shared<TorrentsModel>(store);
+
+			QObject::connect(model.get(), &QAbstractItemModel::dataChanged, [this](const QModelIndex & tl, const QModelIndex & br)
+			{
+				changes.emplace_back(tl, br);
+			});
+		}
+
+		auto row_of(torrent_id_type id) const -> int
+		{
+			for (int row = 0; row < model->rowCount(); ++row)
+			{
+				auto * ptr = qvariant_cast<const torrent *>(model->GetEntity(model->index(row, 0)));
+				if (ptr->id() == id) return row;
+			}
+
+			BOOST_FAIL("torrent is not found in model");
+			return -1;
+		}
+
+		bool invalidated(int row, int column) const
+		{
+			for (auto & [tl, br] : changes)
+			{
+				if (tl.row() <= row and row <= br.row() and tl.column() <= column and column <= br.column())
+					return true;
+			}
+
+			return false;
+		}
+	};
+}
+
+BOOST_FIXTURE_TEST_SUITE(torrents_model_tests, model_fixture)
+
+BOOST_AUTO_TEST_CASE(other_field_change_invalidates_list_row)
+{
+	// list mode view shows model column 1, while delegate paints whole row from all fields
+	const int list_column = 1;
+
+	auto torrents = make_torrents(10);
+	torrents[4].download_speed(1);
+	torrents[5].download_speed(1);
+	torrents[8].current_size(100);
+	store->upsert_records(std::move(torrents));
+
+	BOOST_CHECK(invalidated(row_of(5), list_column));
+	BOOST_CHECK(invalidated(row_of(6), list_column));
+	BOOST_CHECK(invalidated(row_of(9), list_column));
+
+	BOOST_CHECK(not invalidated(row_of(1), list_column));
+	BOOST_CHECK(not invalidated(row_of(1), 0));
+}
+
+BOOST_AUTO_TEST_CASE(unchanged_upsert_emits_nothing)
+{
+	store->upsert_records(make_torrents(10));
+	BOOST_CHECK(changes.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
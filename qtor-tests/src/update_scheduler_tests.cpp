@@ -0,0 +1,53 @@
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include <qtor/update_scheduler.hpp>
+
+BOOST_AUTO_TEST_SUITE(update_scheduler_tests)
+
+BOOST_AUTO_TEST_CASE(post_replaces_pending)
+{
+	qtor::update_scheduler scheduler;
+	std::string log;
+	int key1, key2;
+
+	BOOST_CHECK(scheduler.post(&key1, [&log] { log += "a"; }));
+	BOOST_CHECK(scheduler.post(&key2, [&log] { log += "b"; }));
+	BOOST_CHECK(not scheduler.post(&key1, [&log] { log += "c"; }));
+
+	scheduler.flush();
+	BOOST_CHECK_EQUAL(log, "cb");
+}
+
+BOOST_AUTO_TEST_CASE(cancel_within_flush)
+{
+	qtor::update_scheduler scheduler;
+	std::string log;
+	int key1, key2, key3;
+
+	// first action destroys store of second one, as selection change does with detail stores
+	scheduler.post(&key1, [&] { log += "a"; scheduler.cancel(&key2); });
+	scheduler.post(&key2, [&log] { log += "b"; });
+	scheduler.post(&key3, [&log] { log += "c"; });
+
+	scheduler.flush();
+	BOOST_CHECK_EQUAL(log, "ac");
+}
+
+BOOST_AUTO_TEST_CASE(post_within_flush)
+{
+	qtor::update_scheduler scheduler;
+	std::string log;
+	int key1, key2;
+
+	// posted during flush goes to next one, even if key was already run in this one
+	scheduler.post(&key1, [&] { log += "a"; scheduler.post(&key1, [&log] { log += "x"; }); });
+	scheduler.post(&key2, [&log] { log += "b"; });
+
+	scheduler.flush();
+	BOOST_CHECK_EQUAL(log, "ab");
+
+	scheduler.flush();
+	BOOST_CHECK_EQUAL(log, "abx");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
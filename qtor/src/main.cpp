@@ -25,6 +25,11 @@
 
 #include <qtor/abstract_data_source.hpp>
 #include <qtor/transmission/data_source.hpp>
+#include <qtor/transmission/replay_data_source.hpp>
+#include <qtor/multi_data_source.hpp>
+#include <qtor/tracing.hpp>
+#include <qtor/metrics.hpp>
+#include <qtor/update_scheduler.hpp>
 
 #include <qtor/torrent_store.hpp>
 #include <qtor/torrent_file_store.hpp>
@@ -43,6 +48,7 @@
 #include <QtTools/NotificationSystem/NotificationView.hqt>
 #include <QtTools/NotificationSystem/NotificationPopupLayout.hqt>
 
+#include <QtGui/QScreen>
 #include <QtGui/QPainter>
 #include <QtGui/QTextDocument>
 #include <QtGui/QTextBlock>
@@ -51,6 +57,9 @@
 #include <QtTools/ItemViewUtils.hpp>
 #include <QtTools/ListModel.hqt>
 
+#include <QtCore/QDir>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QByteArray>
 #include <QtCore/QString>
 #include <QtCore/QVariant>
@@ -156,11 +165,61 @@ int main(int argc, char * argv[])
 
 	QApplication qapp {argc, argv};
 
+	// QTOR_TRACE=<path> records trace spans from start and writes them as Chrome trace json on exit
+	auto trace_path = qgetenv("QTOR_TRACE").toStdString();
+	tracing::set_thread_name("gui");
+	if (not trace_path.empty()) tracing::enable();
+
+	// QTOR_METRICS=<path> dumps metrics as Prometheus text on exit
+	auto metrics_path = qgetenv("QTOR_METRICS").toStdString();
+
+	// store updates are applied to models at most once per display frame
+	if (auto * screen = qapp.primaryScreen(); screen and screen->refreshRate() > 0)
+		qtor::update_scheduler::instance().set_frame_interval(std::chrono::milliseconds(static_cast<int>(1000 / screen->refreshRate())));
+
 	//auto source = std::make_shared<qtor::sqlite::sqlite_datasource>();
 	//source->set_address("/home/lisachenko/projects/dmlys/qtor/bin/data.db"s);
 
-	auto source = std::make_shared<qtor::transmission::data_source>();
-	source->set_address("http://melkiy:9091/transmission/rpc"s);
+	// every command line argument is a daemon rpc url, several urls are aggregated by multi_data_source
+	auto urls = qapp.arguments();
+	urls.removeFirst();
+	if (urls.isEmpty()) urls.push_back(QStringLiteral("http://melkiy:9091/transmission/rpc"));
+
+	// "replay:<path>" plays back recording made with QTOR_RECORD=<path>,
+	// QTOR_REPLAY_SPEED sets playback speed multiplier, 0 - as fast as possible
+	const QString replay_prefix = QStringLiteral("replay:");
+
+	std::shared_ptr<abstract_data_source> source;
+	if (urls.size() == 1 and urls.front().startsWith(replay_prefix))
+	{
+		auto replay = std::make_shared<qtor::transmission::replay_data_source>();
+		replay->set_address(QtTools::FromQString(urls.front().mid(replay_prefix.size())));
+		if (qEnvironmentVariableIsSet("QTOR_REPLAY_SPEED"))
+			replay->set_speed(qgetenv("QTOR_REPLAY_SPEED").toDouble());
+
+		source = std::move(replay);
+	}
+	else if (urls.size() == 1)
+	{
+		auto transmission = std::make_shared<qtor::transmission::data_source>();
+		transmission->set_address(QtTools::FromQString(urls.front()));
+		if (qEnvironmentVariableIsSet("QTOR_RECORD"))
+			transmission->set_response_recorder(std::make_shared<qtor::transmission::response_recorder>(qgetenv("QTOR_RECORD").toStdString()));
+
+		source = std::move(transmission);
+	}
+	else
+	{
+		auto multi = std::make_shared<qtor::multi_data_source>();
+		for (auto & url : urls)
+		{
+			auto child = std::make_shared<qtor::transmission::data_source>();
+			child->set_address(QtTools::FromQString(url));
+			multi->add_source(std::move(child), url);
+		}
+
+		source = std::move(multi);
+	}
 
 //	source->connect().get();
 //	auto files = source->get_torrent_files("174").get();
@@ -247,7 +306,23 @@ int main(int argc, char * argv[])
 	qapp.setPalette(palette);
 #endif
 
-	qtor::TransmissionRemoteApp app {std::move(source)};
+	// QTOR_SNAPSHOT=<path> overrides warm start snapshot location, empty value disables it.
+	// By default snapshot is kept in cache directory, keyed by daemon urls: torrent ids of one daemon mean nothing to other.
+	// Replay has nothing to warm start from.
+	std::string snapshot_path;
+	if (qEnvironmentVariableIsSet("QTOR_SNAPSHOT"))
+		snapshot_path = qgetenv("QTOR_SNAPSHOT").toStdString();
+	else if (not urls.front().startsWith(replay_prefix))
+	{
+		auto cache_dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+		auto key = QCryptographicHash::hash(urls.join(QLatin1Char('\n')).toUtf8(), QCryptographicHash::Sha1).toHex().left(16);
+		auto filename = QStringLiteral("torrents-%1.snapshot").arg(QString::fromLatin1(key));
+
+		if (not cache_dir.isEmpty() and QDir().mkpath(cache_dir))
+			snapshot_path = QtTools::FromQString(QDir(cache_dir).filePath(filename));
+	}
+
+	qtor::TransmissionRemoteApp app {std::move(source), std::move(snapshot_path)};
 	qtor::MainWindow mainWindow;
 
 	mainWindow.Init(app);
@@ -315,5 +390,12 @@ int main(int argc, char * argv[])
 
 	auto res = qapp.exec();
 	qapp.closeAllWindows();
+
+	if (not trace_path.empty())
+		tracing::write_chrome_trace(trace_path);
+
+	if (not metrics_path.empty())
+		metrics::registry::instance().write_prometheus(metrics_path);
+
 	return res;
 }
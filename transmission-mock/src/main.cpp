@@ -0,0 +1,100 @@
+#include <thread>
+#include <vector>
+#include <iostream>
+
+#include <boost/asio.hpp>
+#include <boost/program_options.hpp>
+
+#include "mock_daemon.hpp"
+#include "mock_server.hpp"
+
+
+void print_help(const boost::program_options::options_description & opts)
+{
+	auto descr = "Mock transmission rpc server serving synthetic torrents, used for benchmarks and testing\n";
+	auto examples = "Examples:\n"
+	    "  transmission-mock --port 9091 --torrents 10000 --latency 20\n"
+	    "  qtor http://localhost:9091/transmission/rpc";
+
+	std::cout
+	    << descr
+	    << opts
+	    << examples
+	    << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+	using namespace std;
+	namespace po = boost::program_options;
+
+	qtor::mock::mock_options options;
+	std::string address = "127.0.0.1";
+	unsigned short port = 9091;
+	unsigned latency = 0;
+	unsigned threads = 1;
+
+	po::options_description opts {"options"};
+	opts.add_options()
+		("help,h", "print help message")
+		("address,a", po::value(&address)->default_value(address), "listen address")
+		("port,p", po::value(&port)->default_value(port), "listen port")
+		("torrents,n", po::value(&options.torrents)->default_value(options.torrents), "number of synthetic torrents")
+		("files", po::value(&options.files_per_torrent)->default_value(options.files_per_torrent), "files per torrent")
+		("peers", po::value(&options.peers_per_torrent)->default_value(options.peers_per_torrent), "peers per active torrent")
+		("trackers", po::value(&options.trackers_per_torrent)->default_value(options.trackers_per_torrent), "trackers per torrent")
+		("latency,l", po::value(&latency)->default_value(latency), "delay of every reply, milliseconds")
+		("padding", po::value(&options.padding)->default_value(options.padding), "additional bytes added to every reply")
+		("seed", po::value(&options.seed)->default_value(options.seed), "random seed of generated torrents")
+		("threads,t", po::value(&threads)->default_value(threads), "number of serving threads")
+		;
+
+	po::variables_map vm;
+
+	try
+	{
+		store(po::parse_command_line(argc, argv, opts), vm);
+
+		if (vm.count("help"))
+		{
+			print_help(opts);
+			return EXIT_SUCCESS;
+		}
+
+		notify(vm);
+	}
+	catch (po::error & ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	try
+	{
+		boost::asio::io_context context;
+		qtor::mock::mock_daemon daemon(options);
+
+		auto endpoint = boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address(address), port);
+		qtor::mock::mock_server server(context, endpoint, daemon, std::chrono::milliseconds(latency));
+
+		boost::asio::signal_set signals(context, SIGINT, SIGTERM);
+		signals.async_wait([&context](auto, auto) { context.stop(); });
+
+		std::cout << "serving " << options.torrents << " torrents on http://" << server.local_endpoint() << "/transmission/rpc" << std::endl;
+
+		std::vector<std::thread> pool;
+		for (unsigned i = 1; i < threads; ++i)
+			pool.emplace_back([&context] { context.run(); });
+
+		context.run();
+		for (auto & thread : pool)
+			thread.join();
+	}
+	catch (std::exception & ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,544 @@
+#include "mock_daemon.hpp"
+
+#include <cmath>
+#include <cctype>
+#include <cassert>
+#include <ctime>
+#include <numeric>
+#include <algorithm>
+#include <iterator>
+
+#include <fmt/format.h>
+
+namespace qtor::mock
+{
+	// transmission statuses, as in transmission.h
+	constexpr int status_stopped = 0;
+	constexpr int status_downloading = 4;
+	constexpr int status_seeding = 6;
+
+	constexpr double min_rate = 1024;
+	constexpr double max_rate = 10 * 1024 * 1024;
+	constexpr std::uint64_t disk_size = 2ull * 1024 * 1024 * 1024 * 1024;
+
+	static std::int64_t unix_now()
+	{
+		return std::time(nullptr);
+	}
+
+	/// Request bodies are scanned linearly, without building a document:
+	/// value of key is found by walking json tokens, strings are skipped as a whole, so their content never matches a key.
+	/// Only what rpc requests use is supported: string values and arrays of strings or numbers.
+	static std::size_t skip_spaces(std::string_view body, std::size_t pos)
+	{
+		while (pos < body.size() and std::isspace(static_cast<unsigned char>(body[pos])))
+			++pos;
+
+		return pos;
+	}
+
+	/// reads json string starting at opening quote at pos, returns position after closing quote
+	static std::size_t read_string(std::string_view body, std::size_t pos, std::string * result)
+	{
+		assert(body[pos] == '"');
+		for (++pos; pos < body.size(); ++pos)
+		{
+			char ch = body[pos];
+			if (ch == '"') return pos + 1;
+			if (ch == '\\' and ++pos < body.size())
+			{
+				ch = body[pos];
+				switch (ch)
+				{
+					case 'n': ch = '\n'; break;
+					case 't': ch = '\t'; break;
+					case 'r': ch = '\r'; break;
+					case 'b': ch = '\b'; break;
+					case 'f': ch = '\f'; break;
+					default:  break; // '"', '\\', '/' as is, \u sequences are not decoded
+				}
+			}
+
+			if (result) result->push_back(ch);
+		}
+
+		return pos;
+	}
+
+	/// position of value of first member with given key, npos if there is no such member
+	static std::size_t find_value(std::string_view body, std::string_view key)
+	{
+		std::string str;
+		for (std::size_t pos = 0; pos < body.size();)
+		{
+			if (body[pos] != '"')
+			{
+				++pos;
+				continue;
+			}
+
+			str.clear();
+			pos = skip_spaces(body, read_string(body, pos, &str));
+			if (pos < body.size() and body[pos] == ':' and str == key)
+				return skip_spaces(body, pos + 1);
+		}
+
+		return std::string_view::npos;
+	}
+
+	static std::string extract_string(std::string_view body, std::string_view key)
+	{
+		auto pos = find_value(body, key);
+		if (pos >= body.size() or body[pos] != '"') return {};
+
+		std::string result;
+		read_string(body, pos, &result);
+		return result;
+	}
+
+	/// returns elements of json array with given key, strings are unquoted, nullopt if there is no such key
+	static std::optional<std::vector<std::string>> extract_array(std::string_view body, std::string_view key)
+	{
+		auto pos = find_value(body, key);
+		if (pos >= body.size() or body[pos] != '[')
+			return std::nullopt;
+
+		std::vector<std::string> result;
+		for (pos = skip_spaces(body, pos + 1); pos < body.size() and body[pos] != ']';)
+		{
+			std::string item;
+			if (body[pos] == '"')
+				pos = read_string(body, pos, &item);
+			else
+			{
+				auto first = pos;
+				while (pos < body.size() and body[pos] != ',' and body[pos] != ']' and not std::isspace(static_cast<unsigned char>(body[pos])))
+					++pos;
+
+				item.assign(body.substr(first, pos - first));
+			}
+
+			result.push_back(std::move(item));
+
+			pos = skip_spaces(body, pos);
+			if (pos < body.size() and body[pos] == ',')
+				pos = skip_spaces(body, pos + 1);
+		}
+
+		return result;
+	}
+
+	static std::optional<std::vector<int>> extract_ids(std::string_view body)
+	{
+		auto items = extract_array(body, "ids");
+		if (not items) return std::nullopt;
+
+		std::vector<int> ids;
+		for (auto & item : *items)
+			ids.push_back(std::atoi(item.c_str()));
+
+		std::sort(ids.begin(), ids.end());
+		return ids;
+	}
+
+	template <class Torrents, class Functor>
+	static void for_each_torrent(Torrents & torrents, const std::optional<std::vector<int>> & ids, Functor func)
+	{
+		if (not ids)
+		{
+			for (auto & torr : torrents)
+				func(torr);
+
+			return;
+		}
+
+		// torrents are sorted by id
+		for (int id : *ids)
+		{
+			auto it = std::lower_bound(torrents.begin(), torrents.end(), id, [](auto & torr, int id) { return torr.id < id; });
+			if (it != torrents.end() and it->id == id)
+				func(*it);
+		}
+	}
+
+	void mock_daemon::generate()
+	{
+		static const char * words[] = {
+			"Linux", "Distribution", "Archive", "Dataset", "Mirror", "Backup", "Collection",
+			"Music", "Video", "Documents", "Snapshot", "Release", "Images", "Source",
+		};
+
+		constexpr auto words_count = std::size(words);
+		std::uniform_real_distribution<double> log_size(std::log(10e6), std::log(20e9));
+		std::uniform_real_distribution<double> fraction(0.0, 1.0);
+		std::uniform_int_distribution<std::size_t> word(0, words_count - 1);
+
+		auto now = unix_now();
+		m_torrents.reserve(m_options.torrents);
+
+		for (unsigned i = 1; i <= m_options.torrents; ++i)
+		{
+			mock_torrent torr;
+			torr.id = i;
+			torr.error = 0;
+			torr.name = fmt::format("{}.{}.{}.{:05}", words[word(m_random)], words[word(m_random)], words[word(m_random)], i);
+			torr.comment = fmt::format("Synthetic torrent #{}", i);
+			torr.creator = "transmission-mock";
+
+			torr.total_size = static_cast<std::uint64_t>(std::exp(log_size(m_random)));
+
+			double kind = fraction(m_random);
+			torr.status = kind < 0.4 ? status_downloading : kind < 0.8 ? status_seeding : status_stopped;
+			torr.have = torr.status == status_seeding ? torr.total_size : static_cast<std::uint64_t>(torr.total_size * fraction(m_random));
+			torr.downloaded = torr.have;
+			torr.uploaded = static_cast<std::uint64_t>(torr.have * 3 * fraction(m_random));
+
+			torr.rate_download = torr.status == status_downloading ? min_rate + (max_rate - min_rate) * fraction(m_random) / 4 : 0;
+			torr.rate_upload = torr.status != status_stopped ? min_rate + (max_rate - min_rate) * fraction(m_random) / 8 : 0;
+
+			torr.created_date = now - 86400 * 365 - i * 60;
+			torr.added_date = now - 86400 * 30 - i * 60;
+			torr.start_date = now - 3600;
+			torr.done_date = torr.status == status_seeding ? now - 86400 : 0;
+			torr.activity_date = now;
+
+			torr.peers_connected = torr.status == status_stopped ? 0 : m_options.peers_per_torrent;
+
+			auto files_count = std::max(1u, m_options.files_per_torrent);
+			auto file_size = torr.total_size / files_count;
+			for (unsigned f = 0; f < files_count; ++f)
+			{
+				mock_file file;
+				file.name = files_count == 1 ? torr.name : fmt::format("{}/{}/file{:03}.bin", torr.name, f % 2 ? "data" : "extra", f);
+				file.length = f + 1 == files_count ? torr.total_size - file_size * f : file_size;
+				file.wanted = true;
+				file.priority = 0;
+				file.have = 0;
+				torr.files.push_back(std::move(file));
+			}
+
+			m_torrents.push_back(std::move(torr));
+		}
+	}
+
+	void mock_daemon::evolve()
+	{
+		auto now = clock_type::now();
+		double dt = std::chrono::duration<double>(now - m_last_update).count();
+		if (dt < 0.1) return;
+
+		m_last_update = now;
+		auto unix_time = unix_now();
+		std::normal_distribution<double> walk(0.0, 0.1);
+
+		for (auto & torr : m_torrents)
+		{
+			if (torr.status == status_downloading)
+			{
+				torr.rate_download = std::clamp(torr.rate_download * std::exp(walk(m_random)), min_rate, max_rate);
+				auto delta = static_cast<std::uint64_t>(torr.rate_download * dt);
+
+				torr.have = std::min(torr.total_size, torr.have + delta);
+				torr.downloaded += delta;
+				torr.activity_date = unix_time;
+
+				if (torr.have == torr.total_size)
+				{
+					torr.status = status_seeding;
+					torr.rate_download = 0;
+					torr.done_date = unix_time;
+				}
+			}
+
+			if (torr.status != status_stopped)
+			{
+				torr.rate_upload = std::clamp(torr.rate_upload * std::exp(walk(m_random)), min_rate, max_rate);
+				torr.uploaded += static_cast<std::uint64_t>(torr.rate_upload * dt);
+			}
+		}
+	}
+
+	void mock_daemon::write_torrent(std::string & out, const mock_torrent & torr, const std::vector<std::string> & fields) const
+	{
+		auto it = std::back_inserter(out);
+		auto now = unix_now();
+		double percent_done = torr.total_size ? static_cast<double>(torr.have) / torr.total_size : 1.0;
+		bool first = true;
+
+		out += '{';
+		for (auto & field : fields)
+		{
+			auto sepr = first ? "" : ",";
+			#define FIELD(value_format, ...) fmt::format_to(it, "{}\"{}\":" value_format, sepr, field, __VA_ARGS__)
+
+			if      (field == "id")              FIELD("{}", torr.id);
+			else if (field == "name")            FIELD("\"{}\"", torr.name);
+			else if (field == "comment")         FIELD("\"{}\"", torr.comment);
+			else if (field == "creator")         FIELD("\"{}\"", torr.creator);
+			else if (field == "hashString")      FIELD("\"{:040x}\"", torr.id * 0x9E3779B97F4A7C15ull);
+			else if (field == "status")          FIELD("{}", torr.status);
+			else if (field == "error")           FIELD("{}", torr.error);
+			else if (field == "errorString")     FIELD("\"{}\"", "");
+			else if (field == "isFinished")      FIELD("{}", torr.have == torr.total_size);
+			else if (field == "isStalled")       FIELD("{}", false);
+			else if (field == "isPrivate")       FIELD("{}", torr.id % 5 == 0);
+			else if (field == "leftUntilDone")   FIELD("{}", torr.total_size - torr.have);
+			else if (field == "sizeWhenDone")    FIELD("{}", torr.total_size);
+			else if (field == "totalSize")       FIELD("{}", torr.total_size);
+			else if (field == "percentDone")     FIELD("{}", percent_done);
+			else if (field == "downloadedEver")  FIELD("{}", torr.downloaded);
+			else if (field == "uploadedEver")    FIELD("{}", torr.uploaded);
+			else if (field == "corruptEver" or field == "curruptEver") FIELD("{}", 0);
+			else if (field == "recheckProgress") FIELD("{}", 0);
+			else if (field == "metadataPercentComplete") FIELD("{}", 1);
+			else if (field == "eta")             FIELD("{}", torr.rate_download > 0 ? static_cast<std::int64_t>((torr.total_size - torr.have) / torr.rate_download) : -1);
+			else if (field == "etaIdle")         FIELD("{}", -1);
+			else if (field == "peersConnected")  FIELD("{}", torr.peers_connected);
+			else if (field == "peersGettingFromUs") FIELD("{}", torr.rate_upload > 0 ? torr.peers_connected / 2 : 0);
+			else if (field == "peersSendingToUs") FIELD("{}", torr.rate_download > 0 ? torr.peers_connected - torr.peers_connected / 2 : 0);
+			else if (field == "webseedsSendingToUs") FIELD("{}", 0);
+			else if (field == "rateDownload")    FIELD("{}", static_cast<std::uint64_t>(torr.rate_download));
+			else if (field == "rateUpload")      FIELD("{}", static_cast<std::uint64_t>(torr.rate_upload));
+			else if (field == "addedDate")       FIELD("{}", torr.added_date);
+			else if (field == "dateCreated")     FIELD("{}", torr.created_date);
+			else if (field == "startDate")       FIELD("{}", torr.start_date);
+			else if (field == "doneDate")        FIELD("{}", torr.done_date);
+			else if (field == "activityDate")    FIELD("{}", torr.activity_date);
+			else if (field == "files" or field == "fileStats")
+			{
+				bool stats = field == "fileStats";
+				fmt::format_to(it, "{}\"{}\":[", sepr, field);
+
+				std::uint64_t have = torr.have;
+				for (std::size_t i = 0; i < torr.files.size(); ++i)
+				{
+					// files are completed in order
+					auto & file = torr.files[i];
+					auto completed = std::min(have, file.length);
+					have -= completed;
+
+					if (stats)
+						fmt::format_to(it, R"({}{{"bytesCompleted":{},"wanted":{},"priority":{}}})", i ? "," : "", completed, file.wanted, file.priority);
+					else
+						fmt::format_to(it, R"({}{{"bytesCompleted":{},"length":{},"name":"{}"}})", i ? "," : "", completed, file.length, file.name);
+				}
+
+				out += ']';
+			}
+			else if (field == "trackers" or field == "trackerStats")
+			{
+				bool stats = field == "trackerStats";
+				fmt::format_to(it, "{}\"{}\":[", sepr, field);
+
+				for (unsigned i = 0; i < m_options.trackers_per_torrent; ++i)
+				{
+					auto host = fmt::format("tracker{}.example.org", (torr.id + i) % 16);
+					if (stats)
+						fmt::format_to(it,
+							R"({}{{"id":{},"tier":{},"host":"http://{}:80","announce":"http://{}/announce","scrape":"http://{}/scrape","seederCount":{},"leecherCount":{},"lastAnnounceTime":{}}})",
+							i ? "," : "", i, i, host, host, host, (torr.id * 7 + i) % 100, (torr.id * 3 + i) % 50, now - 600);
+					else
+						fmt::format_to(it, R"({}{{"id":{},"tier":{},"announce":"http://{}/announce","scrape":"http://{}/scrape"}})", i ? "," : "", i, i, host, host);
+				}
+
+				out += ']';
+			}
+			else if (field == "peers")
+			{
+				fmt::format_to(it, "{}\"peers\":[", sepr);
+
+				for (unsigned i = 0; i < torr.peers_connected; ++i)
+				{
+					// every peer is replaced by new one once a minute, at staggered times
+					auto identity = i + torr.peers_connected * static_cast<std::uint64_t>((now + i * 7) / 60);
+					auto hash = (identity + 1) * 0x9E3779B97F4A7C15ull ^ torr.id;
+					double share = torr.peers_connected ? 1.0 / torr.peers_connected : 0;
+					double jitter = 0.5 + ((hash ^ now) % 100) / 100.0;
+
+					fmt::format_to(it,
+						R"({}{{"address":"10.{}.{}.{}","port":{},"clientName":"Mock {}.{}","flagStr":"{}","progress":{},)"
+						R"("rateToClient":{},"rateToPeer":{},"clientIsChoked":{},"clientIsInterested":{},"peerIsChoked":{},"peerIsInterested":{},)"
+						R"("isDownloadingFrom":{},"isUploadingTo":{},"isEncrypted":{},"isIncoming":{}}})",
+						i ? "," : "",
+						hash >> 8 & 0xFF, hash >> 16 & 0xFF, hash >> 24 & 0xFF, 1024 + hash % 50000,
+						hash % 4, hash % 10, hash % 2 ? "DUEI" : "dUX", (hash % 101) / 100.0,
+						static_cast<std::uint64_t>(torr.rate_download * share * jitter),
+						static_cast<std::uint64_t>(torr.rate_upload * share * jitter),
+						hash % 3 == 0, hash % 2 == 0, hash % 5 == 0, hash % 2 == 1,
+						torr.rate_download > 0, torr.rate_upload > 0, hash % 4 != 0, hash % 3 == 1);
+				}
+
+				out += ']';
+			}
+			else continue;
+
+			#undef FIELD
+			first = false;
+		}
+
+		out += '}';
+	}
+
+	auto mock_daemon::make_response(std::string_view arguments, std::string_view result) const -> std::string
+	{
+		std::string out;
+		out.reserve(arguments.size() + m_options.padding + 64);
+
+		out += R"({"arguments":{)";
+		out += arguments;
+
+		if (m_options.padding)
+		{
+			if (not arguments.empty()) out += ',';
+			out += R"("padding":")";
+			out.append(m_options.padding, 'x');
+			out += '"';
+		}
+
+		fmt::format_to(std::back_inserter(out), R"(}},"result":"{}"}})", result);
+		return out;
+	}
+
+	auto mock_daemon::torrent_get(const std::string & body) -> std::string
+	{
+		auto ids = extract_ids(body);
+		auto fields = extract_array(body, "fields").value_or(std::vector<std::string>());
+
+		std::string arguments = R"("torrents":[)";
+		arguments.reserve(m_torrents.size() * 64 * (fields.size() + 1));
+
+		std::lock_guard lk(m_mutex);
+		evolve();
+
+		bool first = true;
+		for_each_torrent(m_torrents, ids, [&](const mock_torrent & torr)
+		{
+			if (not first) arguments += ',';
+			write_torrent(arguments, torr, fields);
+			first = false;
+		});
+
+		arguments += ']';
+		return make_response(arguments);
+	}
+
+	auto mock_daemon::torrent_action(const std::string & method, const std::string & body) -> std::string
+	{
+		auto ids = extract_ids(body);
+		auto now = unix_now();
+
+		std::lock_guard lk(m_mutex);
+		evolve();
+
+		if (method == "torrent-remove")
+		{
+			std::vector<int> removed;
+			for_each_torrent(m_torrents, ids, [&](const mock_torrent & torr) { removed.push_back(torr.id); });
+
+			auto last = std::remove_if(m_torrents.begin(), m_torrents.end(), [&removed](auto & torr)
+			{
+				return std::binary_search(removed.begin(), removed.end(), torr.id);
+			});
+
+			m_torrents.erase(last, m_torrents.end());
+			return make_response("");
+		}
+
+		for_each_torrent(m_torrents, ids, [&](mock_torrent & torr)
+		{
+			if (method == "torrent-start" or method == "torrent-start-now")
+			{
+				if (torr.status != status_stopped) return;
+
+				torr.status = torr.have == torr.total_size ? status_seeding : status_downloading;
+				torr.rate_download = torr.status == status_downloading ? min_rate : 0;
+				torr.rate_upload = min_rate;
+				torr.start_date = now;
+				torr.peers_connected = m_options.peers_per_torrent;
+			}
+			else if (method == "torrent-stop")
+			{
+				torr.status = status_stopped;
+				torr.rate_download = torr.rate_upload = 0;
+				torr.peers_connected = 0;
+			}
+		});
+
+		// torrent-verify, torrent-reannounce have no visible effect
+		return make_response("");
+	}
+
+	auto mock_daemon::session_get() -> std::string
+	{
+		return make_response(R"json("download-dir":"/var/lib/transmission/downloads","version":"3.00 (mock)","rpc-version":16,"rpc-version-minimum":1)json");
+	}
+
+	auto mock_daemon::session_stats() -> std::string
+	{
+		std::lock_guard lk(m_mutex);
+		evolve();
+
+		double download = 0, upload = 0;
+		std::uint64_t active = 0, paused = 0, downloaded = 0, uploaded = 0;
+
+		for (auto & torr : m_torrents)
+		{
+			download += torr.rate_download;
+			upload += torr.rate_upload;
+			downloaded += torr.downloaded;
+			uploaded += torr.uploaded;
+
+			if (torr.status == status_stopped) ++paused;
+			else if (torr.rate_download > 0 or torr.rate_upload > 0) ++active;
+		}
+
+		auto seconds_active = unix_now() - m_start_time;
+		auto stats = fmt::format(R"({{"uploadedBytes":{},"downloadedBytes":{},"filesAdded":{},"sessionCount":1,"secondsActive":{}}})",
+			uploaded, downloaded, m_torrents.size() * m_options.files_per_torrent, seconds_active);
+
+		auto arguments = fmt::format(
+			R"("activeTorrentCount":{},"pausedTorrentCount":{},"torrentCount":{},"downloadSpeed":{},"uploadSpeed":{},"current-stats":{},"cumulative-stats":{})",
+			active, paused, m_torrents.size(), static_cast<std::uint64_t>(download), static_cast<std::uint64_t>(upload), stats, stats);
+
+		return make_response(arguments);
+	}
+
+	auto mock_daemon::free_space(const std::string & body) -> std::string
+	{
+		auto path = extract_string(body, "path");
+
+		std::lock_guard lk(m_mutex);
+		evolve();
+
+		std::uint64_t used = 0;
+		for (auto & torr : m_torrents)
+			used += torr.have;
+
+		auto free = used < disk_size ? disk_size - used : 0;
+		return make_response(fmt::format(R"("path":"{}","size-bytes":{})", path, free));
+	}
+
+	auto mock_daemon::handle(const std::string & body) -> std::string
+	{
+		auto method = extract_string(body, "method");
+
+		if (method == "torrent-get")   return torrent_get(body);
+		if (method == "session-get")   return session_get();
+		if (method == "session-stats") return session_stats();
+		if (method == "free-space")    return free_space(body);
+
+		if (method == "torrent-start" or method == "torrent-start-now" or method == "torrent-stop" or
+		    method == "torrent-verify" or method == "torrent-reannounce" or method == "torrent-remove")
+		{
+			return torrent_action(method, body);
+		}
+
+		return make_response("", "method name not recognized");
+	}
+
+	mock_daemon::mock_daemon(mock_options options)
+		: m_options(options), m_random(options.seed), m_start_time(unix_now())
+	{
+		generate();
+	}
+}
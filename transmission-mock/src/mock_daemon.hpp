@@ -0,0 +1,99 @@
+#pragma once
+#include <mutex>
+#include <random>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <optional>
+#include <string_view>
+#include <cstdint>
+
+namespace qtor::mock
+{
+	struct mock_options
+	{
+		unsigned torrents = 1000;
+		unsigned files_per_torrent = 4;
+		unsigned peers_per_torrent = 8;
+		unsigned trackers_per_torrent = 2;
+		/// additional bytes added to every response as unused argument
+		std::size_t padding = 0;
+		std::uint32_t seed = 0;
+	};
+
+	struct mock_file
+	{
+		std::string name;
+		std::uint64_t length;
+		std::uint64_t have;
+		bool wanted;
+		int priority;
+	};
+
+	struct mock_torrent
+	{
+		int id;
+		int status; // as in transmission.h: 0 - stopped, 4 - downloading, 6 - seeding
+		int error;
+
+		std::string name;
+		std::string comment;
+		std::string creator;
+
+		std::uint64_t total_size;
+		std::uint64_t have;
+		std::uint64_t uploaded;
+		std::uint64_t downloaded;
+
+		double rate_download;
+		double rate_upload;
+
+		std::int64_t added_date;
+		std::int64_t created_date;
+		std::int64_t start_date;
+		std::int64_t done_date;
+		std::int64_t activity_date;
+
+		unsigned peers_connected;
+		std::vector<mock_file> files;
+	};
+
+	/// Synthetic transmission daemon state.
+	/// Torrents are generated at construction and evolve with wall time:
+	/// rates do random walk, downloading torrents progress and become seeding.
+	/// All methods are thread safe.
+	class mock_daemon
+	{
+	public:
+		using clock_type = std::chrono::steady_clock;
+
+	private:
+		mock_options m_options;
+
+		mutable std::mutex m_mutex;
+		std::mt19937 m_random;
+		std::vector<mock_torrent> m_torrents;
+		clock_type::time_point m_last_update = clock_type::now();
+		std::int64_t m_start_time;
+
+	private:
+		void generate();
+		void evolve();
+		void write_torrent(std::string & out, const mock_torrent & torr, const std::vector<std::string> & fields) const;
+
+		auto torrent_get(const std::string & body) -> std::string;
+		auto torrent_action(const std::string & method, const std::string & body) -> std::string;
+		auto session_get() -> std::string;
+		auto session_stats() -> std::string;
+		auto free_space(const std::string & body) -> std::string;
+
+		auto make_response(std::string_view arguments, std::string_view result = "success") const -> std::string;
+
+	public:
+		/// handles rpc request body and returns response body
+		auto handle(const std::string & body) -> std::string;
+
+	public:
+		mock_daemon(mock_options options);
+	};
+}
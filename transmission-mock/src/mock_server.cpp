@@ -0,0 +1,188 @@
+#include "mock_server.hpp"
+
+#include <cctype>
+#include <istream>
+#include <algorithm>
+#include <fmt/format.h>
+
+namespace qtor::mock
+{
+	class mock_server::connection : public std::enable_shared_from_this<connection>
+	{
+	private:
+		mock_server & m_owner;
+		tcp::socket m_socket;
+		boost::asio::steady_timer m_timer;
+		boost::asio::streambuf m_buffer;
+
+		std::size_t m_content_length = 0;
+		std::string m_session_id;
+		bool m_keep_alive = true;
+
+		std::string m_response;
+
+	private:
+		void read_headers();
+		void read_body();
+		void process();
+		void write();
+		void parse_headers();
+
+	public:
+		void start() { read_headers(); }
+
+	public:
+		connection(mock_server & owner, tcp::socket socket)
+			: m_owner(owner), m_socket(std::move(socket)), m_timer(m_socket.get_executor()) {}
+	};
+
+	static bool iequals(std::string_view s1, std::string_view s2)
+	{
+		return s1.size() == s2.size() and std::equal(s1.begin(), s1.end(), s2.begin(), [](char c1, char c2)
+		{
+			return std::tolower(static_cast<unsigned char>(c1)) == std::tolower(static_cast<unsigned char>(c2));
+		});
+	}
+
+	void mock_server::connection::parse_headers()
+	{
+		std::istream stream(&m_buffer);
+		std::string line;
+
+		m_content_length = 0;
+		m_session_id.clear();
+		m_keep_alive = true;
+
+		// request line
+		std::getline(stream, line);
+
+		while (std::getline(stream, line) and line != "\r")
+		{
+			if (not line.empty() and line.back() == '\r') line.pop_back();
+
+			auto pos = line.find(':');
+			if (pos == line.npos) continue;
+
+			std::string_view name(line.data(), pos);
+			std::string_view value(line.data() + pos + 1, line.size() - pos - 1);
+			while (not value.empty() and value.front() == ' ') value.remove_prefix(1);
+
+			if (iequals(name, "Content-Length"))
+				m_content_length = std::stoull(std::string(value));
+			else if (iequals(name, "X-Transmission-Session-Id"))
+				m_session_id = value;
+			else if (iequals(name, "Connection"))
+				m_keep_alive = not iequals(value, "close");
+		}
+	}
+
+	void mock_server::connection::read_headers()
+	{
+		auto self = shared_from_this();
+		boost::asio::async_read_until(m_socket, m_buffer, "\r\n\r\n", [self](boost::system::error_code ec, std::size_t)
+		{
+			if (ec) return;
+
+			self->parse_headers();
+			self->read_body();
+		});
+	}
+
+	void mock_server::connection::read_body()
+	{
+		if (m_buffer.size() >= m_content_length)
+			return process();
+
+		auto self = shared_from_this();
+		auto transfer = boost::asio::transfer_exactly(m_content_length - m_buffer.size());
+		boost::asio::async_read(m_socket, m_buffer, transfer, [self](boost::system::error_code ec, std::size_t)
+		{
+			if (ec) return;
+			self->process();
+		});
+	}
+
+	void mock_server::connection::process()
+	{
+		auto data = static_cast<const char *>(m_buffer.data().data());
+		std::string body(data, m_content_length);
+		m_buffer.consume(m_content_length);
+
+		auto & session_id = m_owner.m_session_id;
+		if (m_session_id != session_id)
+		{
+			auto content = fmt::format("<h1>409: Conflict</h1><p><code>X-Transmission-Session-Id: {}</code></p>", session_id);
+			m_response = fmt::format(
+				"HTTP/1.1 409 Conflict\r\n"
+				"Server: transmission-mock\r\n"
+				"X-Transmission-Session-Id: {}\r\n"
+				"Content-Type: text/html; charset=ISO-8859-1\r\n"
+				"Content-Length: {}\r\n"
+				"\r\n{}", session_id, content.size(), content);
+
+			// handshake is never delayed
+			return write();
+		}
+
+		auto content = m_owner.m_daemon.handle(body);
+		m_response = fmt::format(
+			"HTTP/1.1 200 OK\r\n"
+			"Server: transmission-mock\r\n"
+			"Content-Type: application/json; charset=UTF-8\r\n"
+			"Content-Length: {}\r\n"
+			"\r\n", content.size());
+
+		m_response += content;
+
+		if (m_owner.m_latency.count() == 0)
+			return write();
+
+		auto self = shared_from_this();
+		m_timer.expires_after(m_owner.m_latency);
+		m_timer.async_wait([self](boost::system::error_code ec)
+		{
+			if (ec) return;
+			self->write();
+		});
+	}
+
+	void mock_server::connection::write()
+	{
+		auto self = shared_from_this();
+		boost::asio::async_write(m_socket, boost::asio::buffer(m_response), [self](boost::system::error_code ec, std::size_t)
+		{
+			if (ec) return;
+
+			if (self->m_keep_alive)
+				self->read_headers();
+			else
+			{
+				boost::system::error_code ignored;
+				self->m_socket.shutdown(tcp::socket::shutdown_both, ignored);
+			}
+		});
+	}
+
+	void mock_server::accept()
+	{
+		m_acceptor.async_accept([this](boost::system::error_code ec, tcp::socket socket)
+		{
+			if (not ec)
+			{
+				socket.set_option(tcp::no_delay(true));
+				std::make_shared<connection>(*this, std::move(socket))->start();
+			}
+
+			if (m_acceptor.is_open())
+				accept();
+		});
+	}
+
+	mock_server::mock_server(boost::asio::io_context & context, tcp::endpoint endpoint, mock_daemon & daemon, std::chrono::milliseconds latency)
+		: m_acceptor(context, endpoint), m_daemon(daemon), m_latency(latency)
+	{
+		std::random_device rd;
+		m_session_id = fmt::format("{:016x}{:016x}", std::uint64_t(rd()) << 32 | rd(), std::uint64_t(rd()) << 32 | rd());
+		accept();
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <chrono>
+#include <memory>
+#include <string>
+#include <boost/asio.hpp>
+
+#include "mock_daemon.hpp"
+
+namespace qtor::mock
+{
+	/// Minimal HTTP/1.1 server for transmission rpc, serves mock_daemon.
+	/// Implements X-Transmission-Session-Id handshake: requests without valid session id get 409 with one.
+	/// Connections are kept alive, each reply can be delayed by configured latency.
+	class mock_server
+	{
+	public:
+		using tcp = boost::asio::ip::tcp;
+
+	private:
+		class connection;
+
+	private:
+		tcp::acceptor m_acceptor;
+		mock_daemon & m_daemon;
+		std::string m_session_id;
+		std::chrono::milliseconds m_latency;
+
+	private:
+		void accept();
+
+	public:
+		auto session_id() const -> const std::string & { return m_session_id; }
+		auto local_endpoint() const { return m_acceptor.local_endpoint(); }
+
+	public:
+		mock_server(boost::asio::io_context & context, tcp::endpoint endpoint, mock_daemon & daemon, std::chrono::milliseconds latency);
+	};
+}
@@ -1,5 +1,9 @@
 ﻿#pragma once
 #include <qtor/abstract_data_source.hpp>
+#include <qtor/string_pool.hpp>
+#include <qtor/transmission/request_cache.hpp>
+#include <qtor/transmission/response_recorder.hpp>
+#include <atomic>
 #include <ext/net/socket_rest_supervisor.hpp>
 
 #include <QtTools/gui_executor.hqt>
@@ -7,6 +11,8 @@
 namespace qtor {
 namespace transmission
 {
+	enum class rpc_method : unsigned; // see requests.hpp
+
 	class data_source :
 		public abstract_data_source,
 		public ext::net::socket_rest_supervisor
@@ -17,8 +23,22 @@ namespace transmission
 	private:
 		std::string m_encoded_uri;
 		std::string m_xtransmission_session;		
+		/// bumped whenever uri or session id changes, subscriptions rebuild cached http requests on mismatch
+		std::atomic<unsigned> m_request_generation = 1;
 		
 		QtTools::gui_executor * m_executor = nullptr;
+		/// round trip of last successful request, in steady_clock::duration ticks
+		std::atomic<std::chrono::steady_clock::rep> m_last_latency = 0;
+		/// if set, subscription responses are recorded, accessed atomically
+		std::shared_ptr<response_recorder> m_recorder;
+
+		/// strings interned by response parsers. Supervisor processes all requests on it's single thread,
+		/// so pool is accessed only from it and needs no locking
+		string_pool m_string_pool;
+
+		/// per torrent detail requests cache, see set_cache_ttl
+		request_cache<torrent_id_type, torrent_file_list> m_files_cache;
+		request_cache<torrent_id_type, tracker_list> m_trackers_cache;
 
 	protected:
 		class request_base;
@@ -30,12 +50,39 @@ namespace transmission
 		class torrent_subscription;
 		class torrent_request;
 		class torrent_file_list_request;
+		class torrent_file_subscription;
 		class tracker_list_request;
+		class torrent_file_map_request;
+		class tracker_map_request;
+		class torrent_detail_request;
+		class torrent_detail_subscription;
+		class torrent_peer_list_request;
+		class torrent_peer_subscription;
+		class session_stat_request;
+		class session_stat_subscription;
 
 		class torrent_action_request;
 
 	protected:
 		void emit_signal(event_sig & sig, event_type ev) override;
+		/// forgets cached detail results, called after actions changing torrents
+		void invalidate_cache();
+		/// sends torrent action request, detail caches are invalidated when it's sent and again when it completes:
+		/// detail request answered in between would otherwise cache pre-action state for whole ttl.
+		/// arguments are additional request arguments, see make_action_command
+		auto send_torrent_action(rpc_method method, torrent_id_list ids, std::string arguments = {}) -> ext::future<void>;
+
+	public:
+		/// for how long completed get_torrent_files/get_trackers results are reused, default 1 second.
+		/// Zero ttl disables reuse of completed results, identical requests in flight are still shared.
+		void set_cache_ttl(std::chrono::steady_clock::duration ttl);
+		auto get_cache_ttl() const -> std::chrono::steady_clock::duration;
+
+	public:
+		/// installs recorder capturing bodies of all subscription responses, nullptr stops recording.
+		/// Recordings can be played back with replay_data_source
+		void set_response_recorder(std::shared_ptr<response_recorder> recorder);
+		auto get_response_recorder() const -> std::shared_ptr<response_recorder>;
 
 	public:
 		void set_address(std::string addr) override;
@@ -45,8 +92,8 @@ namespace transmission
 		auto get_gui_executor() const -> QtTools::gui_executor * override;
 
 	public:
-		virtual auto subscribe_session_stats(session_stat_handler handler) -> ext::net::subscription_handle override { return {}; }
-		virtual ext::future<session_stat> get_session_stats() override { return {}; }
+		virtual auto subscribe_session_stats(session_stat_handler handler) -> ext::net::subscription_handle override;
+		virtual ext::future<session_stat> get_session_stats() override;
 
 	public:
 		auto subscribe_torrents(torrent_handler handler) -> ext::net::subscription_handle override;
@@ -61,21 +108,32 @@ namespace transmission
 		virtual ext::future<void> start_torrents_now(torrent_id_list ids) override;
 		virtual ext::future<void> stop_torrents(torrent_id_list ids) override;
 
-		virtual ext::future<void> verify_torrents(torrent_id_list ids) override { return ext::make_ready_future(); }
-		virtual ext::future<void> announce_torrents(torrent_id_list ids) override { return ext::make_ready_future(); }
-		virtual ext::future<void> set_torrent_location(torrent_id_type id, std::string newloc, bool move) override { return ext::make_ready_future(); }
+		virtual ext::future<void> verify_torrents(torrent_id_list ids) override;
+		virtual ext::future<void> announce_torrents(torrent_id_list ids) override;
+		virtual ext::future<void> set_torrent_location(torrent_id_type id, std::string newloc, bool move) override;
 
-		virtual ext::future<void> remove_torrents(torrent_id_list ids) override { return ext::make_ready_future(); }
-		virtual ext::future<void> purge_torrents(torrent_id_list ids) override { return ext::make_ready_future(); }
+		/// transmission treats request without ids as request for all torrents,
+		/// removing all torrents is never meant - empty ids list fails with std::invalid_argument
+		virtual ext::future<void> remove_torrents(torrent_id_list ids) override;
+		virtual ext::future<void> purge_torrents(torrent_id_list ids) override;
 
 	public:
 		virtual ext::future<torrent_file_list> get_torrent_files(torrent_id_type id) override;
-		virtual ext::future<torrent_peer_list> get_torrent_peers(torrent_id_type id) override { return ext::make_ready_future<torrent_peer_list>({}); }
+		virtual ext::future<torrent_peer_list> get_torrent_peers(torrent_id_type id) override;
 
 		virtual ext::future<tracker_list> get_trackers(torrent_id_type id) override;
 
+		virtual ext::future<torrent_file_map> get_torrent_files(torrent_id_list ids) override;
+		virtual ext::future<tracker_map> get_trackers(torrent_id_list ids) override;
+
+		virtual ext::future<torrent_detail> get_torrent_detail(torrent_id_type id) override;
+		virtual auto subscribe_torrent_detail(torrent_id_type id, torrent_detail_handler handler) -> ext::net::subscription_handle override;
+		virtual auto subscribe_torrent_peers(torrent_id_type id, torrent_peer_handler handler) -> ext::net::subscription_handle override;
+		virtual auto subscribe_torrent_files(torrent_id_type id, torrent_file_handler handler) -> ext::net::subscription_handle override;
+
 	public:
 		virtual std::string last_errormsg() const override { return base_type::last_errormsg(); }
+		virtual auto last_latency() const -> std::chrono::steady_clock::duration override;
 
 	public:
 		data_source() = default;
@@ -0,0 +1,134 @@
+#pragma once
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+
+#include <ext/net/abstract_connection_controller.hpp>
+#include <ext/net/abstract_subscription_controller.hpp>
+#include <qtor/abstract_data_source.hpp>
+#include <qtor/string_pool.hpp>
+#include <qtor/transmission/response_recorder.hpp>
+
+namespace qtor {
+namespace transmission
+{
+	/// Plays back torrent-get responses recorded by response_recorder.
+	/// Address is a path to recording file. Each recorded torrent list is parsed with parse_torrent_list
+	/// and delivered to torrent subscriptions either with original timing(scaled by speed) or as fast as possible.
+	/// At max speed next snapshot is not parsed until previous one is consumed by gui thread.
+	/// Actions are accepted and ignored.
+	class replay_data_source :
+		public abstract_data_source,
+		public ext::net::abstract_connection_controller
+	{
+	protected:
+		class subscription : public ext::net::abstract_subscription_controller
+		{
+			friend replay_data_source;
+			torrent_handler m_handler;
+
+		protected:
+			void do_close_request(unique_lock lk) override;
+			void do_pause_request(unique_lock lk) override;
+			void do_resume_request(unique_lock lk) override;
+		};
+
+		typedef ext::intrusive_ptr<subscription> subscription_ptr;
+
+		/// Shared with snapshots posted to gui executor. Detached when playing stops,
+		/// so snapshots still queued at that time are dropped instead of reaching stopped or destroyed source.
+		struct emit_guard
+		{
+			std::recursive_mutex mutex; // handler may stop source while delivering
+			replay_data_source * owner = nullptr;
+		};
+
+	protected:
+		std::string m_path;
+		double m_speed = 1.0;
+		bool m_loop = false;
+		QtTools::gui_executor * m_executor = nullptr;
+
+		mutable std::mutex m_data_mutex;
+		std::condition_variable m_data_cond;
+		std::thread m_thread;
+		bool m_stopping = false;
+		unsigned m_pending = 0; // snapshots posted to gui executor, not yet delivered
+		std::shared_ptr<emit_guard> m_guard;
+
+		std::vector<subscription_ptr> m_subs;
+		torrent_list m_torrents;
+		std::string m_errmsg;
+		std::atomic<std::size_t> m_played = 0;
+		string_pool m_string_pool; // used only by replay thread
+
+	protected:
+		void do_connect_request(unique_lock lk) override;
+		void do_disconnect_request(unique_lock lk) override;
+
+		void play(std::unique_ptr<response_reader> reader);
+		void emit_torrents(torrent_list list);
+		void deliver(torrent_list & list);
+		void stop_playing();
+
+	public:
+		/// playback speed multiplier, 1.0 - original timing, 0 - as fast as possible
+		void set_speed(double speed) { m_speed = speed; }
+		auto get_speed() const noexcept { return m_speed; }
+		/// start from the beginning after last record
+		void set_loop(bool loop) { m_loop = loop; }
+		auto get_loop() const noexcept { return m_loop; }
+		/// number of snapshots delivered so far
+		auto played_count() const noexcept -> std::size_t { return m_played.load(std::memory_order_relaxed); }
+
+	public:
+		void set_address(std::string addr) override { m_path = std::move(addr); }
+		void set_timeout(std::chrono::steady_clock::duration timeout) override {}
+		void set_logger(ext::library_logger::logger * logger) override {}
+		void set_gui_executor(QtTools::gui_executor * executor) override { m_executor = executor; }
+		auto get_gui_executor() const -> QtTools::gui_executor * override { return m_executor; }
+
+	public:
+		virtual auto subscribe_session_stats(session_stat_handler handler) -> ext::net::subscription_handle override { return {}; }
+		virtual ext::future<session_stat> get_session_stats() override { return ext::make_ready_future(session_stat()); }
+
+	public:
+		auto subscribe_torrents(torrent_handler handler) -> ext::net::subscription_handle override;
+
+		virtual ext::future<torrent_list> get_torrents() override;
+		virtual ext::future<torrent_list> get_torrents(torrent_id_list ids) override;
+
+		virtual ext::future<void> start_all_torrents() override { return ext::make_ready_future(); }
+		virtual ext::future<void> stop_all_torrents() override { return ext::make_ready_future(); }
+
+		virtual ext::future<void> start_torrents(torrent_id_list ids) override { return ext::make_ready_future(); }
+		virtual ext::future<void> start_torrents_now(torrent_id_list ids) override { return ext::make_ready_future(); }
+		virtual ext::future<void> stop_torrents(torrent_id_list ids) override { return ext::make_ready_future(); }
+
+		virtual ext::future<void> verify_torrents(torrent_id_list ids) override { return ext::make_ready_future(); }
+		virtual ext::future<void> announce_torrents(torrent_id_list ids) override { return ext::make_ready_future(); }
+		virtual ext::future<void> set_torrent_location(torrent_id_type id, std::string newloc, bool move) override { return ext::make_ready_future(); }
+
+		virtual ext::future<void> remove_torrents(torrent_id_list ids) override { return ext::make_ready_future(); }
+		virtual ext::future<void> purge_torrents(torrent_id_list ids) override { return ext::make_ready_future(); }
+
+	public:
+		virtual ext::future<torrent_file_list> get_torrent_files(torrent_id_type id) override { return ext::make_ready_future(torrent_file_list()); }
+		virtual ext::future<torrent_file_map> get_torrent_files(torrent_id_list ids) override { return ext::make_ready_future(torrent_file_map()); }
+		virtual ext::future<torrent_peer_list> get_torrent_peers(torrent_id_type id) override { return ext::make_ready_future(torrent_peer_list()); }
+
+		virtual ext::future<torrent_detail> get_torrent_detail(torrent_id_type id) override;
+		virtual auto subscribe_torrent_detail(torrent_id_type id, torrent_detail_handler handler) -> ext::net::subscription_handle override { return {}; }
+		virtual auto subscribe_torrent_peers(torrent_id_type id, torrent_peer_handler handler) -> ext::net::subscription_handle override { return {}; }
+		virtual auto subscribe_torrent_files(torrent_id_type id, torrent_file_handler handler) -> ext::net::subscription_handle override { return {}; }
+
+	public:
+		virtual std::string last_errormsg() const override;
+
+	public:
+		replay_data_source() = default;
+		~replay_data_source();
+	};
+}}
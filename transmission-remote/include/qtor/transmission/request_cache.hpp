@@ -0,0 +1,119 @@
+#pragma once
+#include <mutex>
+#include <chrono>
+#include <unordered_map>
+#include <ext/future.hpp>
+
+namespace qtor {
+namespace transmission
+{
+	/// Keyed cache of in flight and recently completed requests.
+	/// Concurrent requests with same key share one ext::shared_future,
+	/// successfully completed results are reused while they are younger than ttl.
+	/// Failed requests are never reused - next acquire issues new one.
+	template <class Key, class Type>
+	class request_cache
+	{
+	public:
+		using key_type   = Key;
+		using value_type = Type;
+		using clock_type = std::chrono::steady_clock;
+		using duration   = clock_type::duration;
+		using time_point = clock_type::time_point;
+
+	private:
+		/// result with time point it was completed at
+		struct stamped_value
+		{
+			time_point completed;
+			value_type value;
+		};
+
+		using shared_future = ext::shared_future<stamped_value>;
+
+	private:
+		mutable std::mutex m_mutex;
+		std::unordered_map<key_type, shared_future> m_entries;
+		duration m_ttl = std::chrono::seconds(1);
+
+		/// stale entries are swept when cache grows beyond this size
+		static constexpr std::size_t ms_sweep_threshold = 64;
+
+	private:
+		bool is_reusable(const shared_future & result, time_point now) const;
+		void sweep(time_point now);
+
+	public:
+		void set_ttl(duration ttl);
+		auto get_ttl() const -> duration;
+
+		/// returns shared result for key if there is one in flight or fresh enough,
+		/// otherwise calls factory() -> ext::future<value_type>, remembers and returns it's result
+		template <class Factory>
+		auto acquire(const key_type & key, Factory && factory) -> ext::future<value_type>;
+
+		/// forgets all cached results, requests in flight are not affected
+		void clear();
+	};
+
+
+	template <class Key, class Type>
+	inline bool request_cache<Key, Type>::is_reusable(const shared_future & result, time_point now) const
+	{
+		if (not result.valid()) return false;
+		if (not result.is_ready()) return true;
+		if (result.has_exception() or result.is_cancelled()) return false;
+
+		return now - result.get().completed < m_ttl;
+	}
+
+	template <class Key, class Type>
+	void request_cache<Key, Type>::sweep(time_point now)
+	{
+		for (auto it = m_entries.begin(); it != m_entries.end();)
+		{
+			if (is_reusable(it->second, now)) ++it;
+			else it = m_entries.erase(it);
+		}
+	}
+
+	template <class Key, class Type>
+	inline void request_cache<Key, Type>::set_ttl(duration ttl)
+	{
+		std::lock_guard lk(m_mutex);
+		m_ttl = ttl;
+	}
+
+	template <class Key, class Type>
+	inline auto request_cache<Key, Type>::get_ttl() const -> duration
+	{
+		std::lock_guard lk(m_mutex);
+		return m_ttl;
+	}
+
+	template <class Key, class Type>
+	template <class Factory>
+	auto request_cache<Key, Type>::acquire(const key_type & key, Factory && factory) -> ext::future<value_type>
+	{
+		auto unwrap = [](shared_future result) -> value_type { return result.get().value; };
+		auto stamp  = [](ext::future<value_type> result) -> stamped_value { return {clock_type::now(), result.get()}; };
+
+		auto now = clock_type::now();
+		std::lock_guard lk(m_mutex);
+		if (m_entries.size() >= ms_sweep_threshold)
+			sweep(now);
+
+		auto & entry = m_entries[key];
+		if (not is_reusable(entry, now))
+			entry = std::forward<Factory>(factory)().then(stamp).share();
+
+		return entry.then(unwrap);
+	}
+
+	template <class Key, class Type>
+	inline void request_cache<Key, Type>::clear()
+	{
+		std::lock_guard lk(m_mutex);
+		m_entries.clear();
+	}
+}}
@@ -2,7 +2,7 @@
 #include <string>
 #include <vector>
 #include <istream>
-#include <regex>
+#include <string_view>
 
 #include <ext/itoa.hpp>
 #include <ext/type_traits.hpp>
@@ -11,11 +11,14 @@
 #include <boost/algorithm/string/find_format.hpp>
 #include <boost/algorithm/string/finder.hpp>
 #include <boost/range/adaptor/transformed.hpp>
+#include <boost/range/value_type.hpp>
 
 #include <fmt/format.h>
 
 #include <qtor/torrent.hpp>
 #include <qtor/torrent_file.hpp>
+#include <qtor/torrent_detail.hpp>
+#include <qtor/string_pool.hpp>
 
 
 namespace qtor {
@@ -42,30 +45,36 @@ namespace transmission
 		return boost::adaptors::transform(range, [](const QString & qstr) { return qstr.toLong(); });
 	}
 
-	template <class Range, std::enable_if_t<not ext::is_range_of_v<Range, QString>, int> = 0>
+	template <class Range, std::enable_if_t<ext::is_range_of_v<Range, std::string>, int> = 0>
 	inline auto operator |(const Range & range, as_ints_t) noexcept
 	{
 		return boost::adaptors::transform(range, [](const auto & str) { return std::stol(str); });
 	}
 
+	/// torrent_id_type ranges are already integral
+	template <class Range, std::enable_if_t<std::is_integral_v<typename boost::range_value<Range>::type>, int> = 0>
+	inline decltype(auto) operator |(const Range & range, as_ints_t) noexcept
+	{
+		return range;
+	}
+
 
-	/// json request template.
-	/// All requests follow same template:
-	///   method - ...
-	///   fields - ...
-	///   ids    - ... for all field ids should be absent.
 	inline namespace constants
 	{
-		extern const std::string request_template;
-		extern const std::string request_template_all;
-		extern const std::string command_template;
-		extern const std::string command_template_all;
-
 		extern const std::vector<std::string> request_default_fields;
 		extern const std::vector<std::string> request_torrent_files_fields;
+		// only fileStats: have size, wanted, priority - no names and lengths
+		extern const std::vector<std::string> request_torrent_file_stats_fields;
 		extern const std::vector<std::string> request_torrent_peers_fields;
 		extern const std::vector<std::string> request_trackers_fields;
 
+		// batched requests variants, additionally request torrent id
+		extern const std::vector<std::string> request_torrent_files_batch_fields;
+		extern const std::vector<std::string> request_trackers_batch_fields;
+
+		// union of files, trackers and peers fields, see torrent_detail
+		extern const std::vector<std::string> request_torrent_detail_fields;
+
 		// commands
 		extern const std::string torrent_get;
 		extern const std::string torrent_set;
@@ -77,11 +86,37 @@ namespace transmission
 		extern const std::string torrent_verify;
 		extern const std::string torrent_reannounce;
 
-		extern std::regex method_regex;
+		extern const std::string torrent_remove;
+		extern const std::string torrent_set_location;
+
+		extern const std::string session_get;
+		extern const std::string session_stats;
+		extern const std::string free_space;
 	}
 
+	/// rpc methods, every request carries its method as a tag,
+	/// so logging, metrics and tracing do not need to look into request body
+	enum class rpc_method : unsigned
+	{
+		torrent_get, torrent_set, torrent_add,
+		torrent_start, torrent_start_now, torrent_stop,
+		torrent_verify, torrent_reannounce,
+		torrent_remove, torrent_set_location,
+		session_get, session_stats, free_space,
+	};
+
+	constexpr std::size_t rpc_method_count = static_cast<std::size_t>(rpc_method::free_space) + 1;
 
-	std::string_view extract_command(std::string_view command);
+	/// method name as in transmission rpc spec, e.g. "torrent-get"
+	auto method_name(rpc_method method) noexcept -> std::string_view;
+
+	/// requests bodies are written into reusable buffer
+	using request_buffer = fmt::memory_buffer;
+
+	inline void append(request_buffer & out, std::string_view str)
+	{
+		out.append(str.data(), str.data() + str.size());
+	}
 
 	
 	template <class String, class OutContainer>
@@ -166,28 +201,129 @@ namespace transmission
 	}
 	
 
+	/// writes "val1", "val2", ... with json escaping
+	template <class Range>
+	void write_json_strings(request_buffer & out, const Range & values)
+	{
+		bool first = true;
+		for (const auto & val : values)
+		{
+			if (not first) append(out, ", ");
+			first = false;
+
+			out.push_back('"');
+			for (char ch : std::string_view(val))
+			{
+				if (ch == '"' or ch == '\\') out.push_back('\\');
+				out.push_back(ch);
+			}
+			out.push_back('"');
+		}
+	}
+
+	/// writes val1, val2, ...
+	template <class Range>
+	void write_json_ints(request_buffer & out, const Range & values)
+	{
+		bool first = true;
+		for (auto val : values)
+		{
+			if (not first) append(out, ", ");
+			first = false;
+
+			fmt::format_to(std::back_inserter(out), "{}", val);
+		}
+	}
+
+	/// All requests follow same template:
+	///   { "method": "...", "arguments": { "fields": [ ... ], "ids": [ ... ] } }
+	/// for all torrents ids are absent, commands have no fields.
 	template <class IdsRange>
-	std::string make_request_command(std::string_view command, const IdsRange & ids)
+	void make_request_command(request_buffer & out, rpc_method method, const IdsRange & ids)
 	{
+		append(out, R"({ "method": ")");
+		append(out, method_name(method));
+
 		if (boost::empty(ids))
-			return fmt::format(command_template_all, command);
+			append(out, R"(" })");
 		else
-			return fmt::format(command_template, command, json_join(ids | as_ints));
+		{
+			append(out, R"(", "arguments": { "ids": [ )");
+			write_json_ints(out, ids | as_ints);
+			append(out, " ] } }");
+		}
 	}
 
 	template <class IdsRange, class FieldsRange>
-	std::string make_request_command(std::string_view command, const IdsRange & ids, const FieldsRange & fields)
+	void make_request_command(request_buffer & out, rpc_method method, const IdsRange & ids, const FieldsRange & fields)
 	{
+		append(out, R"({ "method": ")");
+		append(out, method_name(method));
+		append(out, R"(", "arguments": { "fields": [ )");
+		write_json_strings(out, fields);
+
 		if (boost::empty(ids))
-			return fmt::format(request_template_all, command, json_join(fields));
+			append(out, " ] } }");
 		else
-			return fmt::format(request_template, command, json_join(fields), json_join(ids | as_ints));
+		{
+			append(out, R"( ], "ids": [ )");
+			write_json_ints(out, ids | as_ints);
+			append(out, " ] } }");
+		}
 	}
 
+	/// action command with additional arguments:
+	///   { "method": "...", "arguments": { "ids": [ ... ], <arguments> } }
+	/// arguments are json object members, like "move": true, if empty - same as make_request_command
+	template <class IdsRange>
+	void make_action_command(request_buffer & out, rpc_method method, const IdsRange & ids, std::string_view arguments)
+	{
+		if (arguments.empty())
+			return make_request_command(out, method, ids);
+
+		append(out, R"({ "method": ")");
+		append(out, method_name(method));
+		append(out, R"(", "arguments": { )");
+
+		if (not boost::empty(ids))
+		{
+			append(out, R"("ids": [ )");
+			write_json_ints(out, ids | as_ints);
+			append(out, " ], ");
+		}
+
+		append(out, arguments);
+		append(out, " } }");
+	}
+
+	/// torrent-remove arguments, see make_action_command
+	inline auto make_torrent_remove_arguments(bool delete_local_data) -> std::string
+	{
+		return delete_local_data ? R"("delete-local-data": true)" : R"("delete-local-data": false)";
+	}
+
+	/// torrent-set-location arguments, see make_action_command
+	auto make_torrent_set_location_arguments(const std::string & location, bool move) -> std::string;
+
+	template <class IdsRange, class FieldsRange>
+	void make_torrent_get_command(request_buffer & out, const IdsRange & ids, const FieldsRange & fields)
+	{
+		make_request_command(out, rpc_method::torrent_get, ids, fields);
+	}
+
+	template <class IdsRange>
+	void make_torrent_get_command(request_buffer & out, const IdsRange & ids)
+	{
+		make_torrent_get_command(out, ids, request_default_fields);
+	}
+
+	/// std::string variants, for tools and tests
 	template <class IdsRange, class FieldsRange>
 	std::string make_torrent_get_command(const IdsRange & ids, const FieldsRange & fields)
 	{
-		return make_request_command(torrent_get, ids, fields);
+		request_buffer out;
+		make_torrent_get_command(out, ids, fields);
+		return fmt::to_string(out);
 	}
 
 	template <class IdsRange>
@@ -197,30 +333,95 @@ namespace transmission
 	}
 
 
-	inline std::string make_torrent_files_get_command(const torrent_id_type & id)
+	inline void make_torrent_files_get_command(request_buffer & out, const torrent_id_type & id)
+	{
+		auto ids = {id};
+		make_torrent_get_command(out, ids, request_torrent_files_fields);
+	}
+
+	inline void make_torrent_file_stats_get_command(request_buffer & out, const torrent_id_type & id)
+	{
+		auto ids = {id};
+		make_torrent_get_command(out, ids, request_torrent_file_stats_fields);
+	}
+
+	inline void make_tracker_list_get_command(request_buffer & out, const torrent_id_type & id)
+	{
+		auto ids = {id};
+		make_torrent_get_command(out, ids, request_trackers_fields);
+	}
+
+	inline void make_torrent_peers_get_command(request_buffer & out, const torrent_id_type & id)
 	{
 		auto ids = {id};
-		return make_torrent_get_command(ids, request_torrent_files_fields);
+		make_torrent_get_command(out, ids, request_torrent_peers_fields);
 	}
 
-	inline std::string make_tracker_list_get_command(const torrent_id_type & id)
+	inline void make_torrent_detail_get_command(request_buffer & out, const torrent_id_type & id)
 	{
 		auto ids = {id};
-		return make_torrent_get_command(ids, request_trackers_fields);
+		make_torrent_get_command(out, ids, request_torrent_detail_fields);
+	}
+
+	template <class IdsRange>
+	void make_torrent_files_batch_get_command(request_buffer & out, const IdsRange & ids)
+	{
+		make_torrent_get_command(out, ids, request_torrent_files_batch_fields);
 	}
 
+	template <class IdsRange>
+	void make_tracker_list_batch_get_command(request_buffer & out, const IdsRange & ids)
+	{
+		make_torrent_get_command(out, ids, request_trackers_batch_fields);
+	}
+
+	inline void make_session_stats_command(request_buffer & out)
+	{
+		make_request_command(out, rpc_method::session_stats, std::initializer_list<torrent_id_type>());
+	}
+
+	/// session-get restricted to download-dir, only thing needed for free-space requests
+	void make_download_dir_get_command(request_buffer & out);
+	void make_free_space_command(request_buffer & out, const string_type & path);
+
 	void parse_command_response(const std::string & json);
 	void parse_command_response(std::istream & json_stream);
 
-	torrent_list parse_torrent_list(const std::string & json);
-	torrent_list parse_torrent_list(std::istream & json_stream);
+	/// parsers taking string_pool intern repeating strings(creators, comments, errors, tracker urls, peer clients, file paths) into it,
+	/// without pool every string has own buffer
+	torrent_list parse_torrent_list(const std::string & json, string_pool * pool = nullptr);
+	torrent_list parse_torrent_list(std::istream & json_stream, string_pool * pool = nullptr);
+
+	torrent_file_list parse_torrent_file_list(const std::string & json, string_pool * pool = nullptr);
+	torrent_file_list parse_torrent_file_list(std::istream & json_source, string_pool * pool = nullptr);
+
+	/// parses fileStats of first torrent, entries are in file index order
+	torrent_file_stat_list parse_torrent_file_stat_list(const std::string & json);
+	torrent_file_stat_list parse_torrent_file_stat_list(std::istream & json_source);
 
-	torrent_file_list parse_torrent_file_list(const std::string & json);
-	torrent_file_list parse_torrent_file_list(std::istream & json_source);
+	tracker_list parse_tracker_list(const std::string & json, string_pool * pool = nullptr);
+	tracker_list parse_tracker_list(std::istream & json_source, string_pool * pool = nullptr);
 
-	tracker_list parse_tracker_list(const std::string & json);
-	tracker_list parse_tracker_list(std::istream & json_source);
+	torrent_peer_list parse_torrent_peer_list(const std::string & json, string_pool * pool = nullptr);
+	torrent_peer_list parse_torrent_peer_list(std::istream & json_source, string_pool * pool = nullptr);
+
+	/// parses files, trackers and peers of first torrent in one pass
+	torrent_detail parse_torrent_detail(const std::string & json, string_pool * pool = nullptr);
+	torrent_detail parse_torrent_detail(std::istream & json_source, string_pool * pool = nullptr);
+
+	/// parse batched responses, all torrents entries from response are returned keyed by torrent id
+	torrent_file_map parse_torrent_file_map(const std::string & json, string_pool * pool = nullptr);
+	torrent_file_map parse_torrent_file_map(std::istream & json_source, string_pool * pool = nullptr);
+
+	tracker_map parse_tracker_map(const std::string & json, string_pool * pool = nullptr);
+	tracker_map parse_tracker_map(std::istream & json_source, string_pool * pool = nullptr);
 
 	session_stat parse_statistics(const std::string & json);
 	session_stat parse_statistics(std::istream & json_stream);
+
+	string_type parse_download_dir(const std::string & json);
+	string_type parse_download_dir(std::istream & json_stream);
+
+	size_type parse_free_space(const std::string & json);
+	size_type parse_free_space(std::istream & json_stream);
 }}
@@ -0,0 +1,59 @@
+#pragma once
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <cstdint>
+
+namespace qtor {
+namespace transmission
+{
+	/// Recorded rpc traffic file format, all integers are little endian:
+	///   header: 8 bytes magic "QTORREC\1"
+	///   record: uint64 microseconds since recording start,
+	///           uint8  method length, method bytes,
+	///           uint32 body length, body bytes
+	struct recorded_response
+	{
+		std::chrono::microseconds time;
+		std::string method;
+		std::string body;
+	};
+
+	/// Appends rpc response bodies to recording file, thread safe.
+	/// Installed into data_source via set_response_recorder.
+	class response_recorder
+	{
+	private:
+		std::mutex m_mutex;
+		std::ofstream m_stream;
+		std::chrono::steady_clock::time_point m_start;
+
+	public:
+		void record(std::string_view method, std::string_view body);
+		void flush();
+
+	public:
+		/// opens file for writing, throws std::runtime_error on failure
+		response_recorder(const std::string & path);
+		~response_recorder();
+	};
+
+	/// Sequentially reads records written by response_recorder
+	class response_reader
+	{
+	private:
+		std::ifstream m_stream;
+
+	public:
+		/// reads next record, returns false at end of file
+		bool next(recorded_response & rec);
+		/// restarts reading from first record
+		void rewind();
+
+	public:
+		/// opens file for reading, throws std::runtime_error if file can't be opened or it is not a recording
+		response_reader(const std::string & path);
+	};
+}}
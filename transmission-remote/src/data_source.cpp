@@ -1,11 +1,15 @@
 ﻿#include <qtor/transmission/data_source.hpp>
 #include <qtor/transmission/requests.hpp>
+#include <qtor/tracing.hpp>
+#include <qtor/metrics.hpp>
 
 #include <ext/net/parse_url.hpp>
 #include <ext/net/http_parser.hpp>
 #include <ext/library_logger/logging_macros.hpp>
 
-#include <regex>
+#include <array>
+#include <algorithm>
+#include <stdexcept>
 #include <fmt/format.h>
 
 namespace qtor {
@@ -23,6 +27,7 @@ namespace transmission
 	{
 		auto parsed = ext::net::parse_url(addr);
 		m_encoded_uri = parsed.path;
+		m_request_generation.fetch_add(1, std::memory_order_relaxed);
 
 		std::string service = parsed.port.empty() ? "http" : parsed.port;
 		base_type::set_address(parsed.host, std::move(service));
@@ -47,15 +52,90 @@ namespace transmission
 	{
 		return m_executor;
 	}
+
+	void data_source::set_cache_ttl(std::chrono::steady_clock::duration ttl)
+	{
+		m_files_cache.set_ttl(ttl);
+		m_trackers_cache.set_ttl(ttl);
+	}
+
+	auto data_source::get_cache_ttl() const -> std::chrono::steady_clock::duration
+	{
+		return m_files_cache.get_ttl();
+	}
+
+	auto data_source::last_latency() const -> std::chrono::steady_clock::duration
+	{
+		return std::chrono::steady_clock::duration(m_last_latency.load(std::memory_order_relaxed));
+	}
+
+	void data_source::set_response_recorder(std::shared_ptr<response_recorder> recorder)
+	{
+		std::atomic_store(&m_recorder, std::move(recorder));
+	}
+
+	auto data_source::get_response_recorder() const -> std::shared_ptr<response_recorder>
+	{
+		return std::atomic_load(&m_recorder);
+	}
+
+	void data_source::invalidate_cache()
+	{
+		m_files_cache.clear();
+		m_trackers_cache.clear();
+	}
 	
+	/// metrics of rpc method, looked up once
+	static metrics::rpc_metrics & method_metrics(rpc_method method)
+	{
+		static const auto cache = []
+		{
+			std::array<metrics::rpc_metrics *, rpc_method_count> cache;
+			for (std::size_t idx = 0; idx < rpc_method_count; ++idx)
+				cache[idx] = &metrics::rpc(method_name(static_cast<rpc_method>(idx)));
+
+			return cache;
+		}();
+
+		return *cache[static_cast<std::size_t>(method)];
+	}
+
+	/// writes complete http POST request: headers followed by body
+	static void make_http_request(request_buffer & out, std::string_view uri, std::string_view host,
+	                              std::string_view session, const request_buffer & body)
+	{
+		fmt::format_to(std::back_inserter(out),
+			"POST {} HTTP/1.1\r\n"
+			"Host: {}\r\n"
+			"Content-Length: {}\r\n"
+			"Accept-Encoding: deflate, gzip\r\n",
+			uri, host, body.size());
+
+		if (not session.empty())
+			fmt::format_to(std::back_inserter(out), "X-Transmission-Session-Id: {}\r\n", session);
+
+		append(out, "\r\n");
+		out.append(body.data(), body.data() + body.size());
+	}
+
 	class data_source::request_base : public base_type::request_base
 	{
+	protected:
+		std::chrono::steady_clock::time_point m_sent;
+		rpc_method m_method = rpc_method::torrent_get; // set by derived constructors
+		request_buffer m_body;
+		request_buffer m_http;
+
 	public:
 		void request(ext::net::socket_streambuf & streambuf) override;
 		void response(ext::net::socket_streambuf & streambuf) override;
 
+	protected:
+		/// string pool of owner, responses are parsed on supervisor thread
+		auto pool() const -> string_pool * { return &static_cast<data_source *>(m_owner)->m_string_pool; }
+
 	public:
-		virtual auto request_command() -> std::string = 0;
+		virtual void request_command(request_buffer & out) = 0;
 		virtual void parse_response(std::string body) = 0;
 	};
 
@@ -64,10 +144,23 @@ namespace transmission
 	protected:
 		std::chrono::steady_clock::time_point m_next = std::chrono::steady_clock::now();
 		std::chrono::steady_clock::duration m_delay = std::chrono::seconds(2);
+		std::chrono::steady_clock::time_point m_sent;
+		rpc_method m_method = rpc_method::torrent_get; // set by derived constructors or request_command
+
+		// Request is same from tick to tick, it's built once and resent as is.
+		// Body is rebuilt after invalidate_request, http request - also when owner m_request_generation changes
+		request_buffer m_body;
+		request_buffer m_http;
+		unsigned m_http_generation = 0;  // owner generation m_http was built for, 0 - not built
+		bool m_body_valid = false;
 
 	protected:
 		template <class Data, class Handler>
 		void emit_data(Data data, const Handler & handler);
+		/// drops cached request, should be called when request_command output changes: ids, fields, stage
+		void invalidate_request() noexcept { m_body_valid = false; m_http_generation = 0; }
+		/// string pool of owner, responses are parsed on supervisor thread
+		auto pool() const -> string_pool * { return &static_cast<data_source *>(m_owner)->m_string_pool; }
 		
 	public:
 		void request(ext::net::socket_streambuf & streambuf) override;
@@ -75,21 +168,34 @@ namespace transmission
 		auto next_invoke() -> std::chrono::steady_clock::time_point override { return m_next; }
 
 	public:
-		virtual auto request_command() -> std::string = 0;
+		virtual void request_command(request_buffer & out) = 0;
 		virtual void process_response(std::string body) = 0;
+		/// name under which responses are recorded, see response_recorder
+		virtual auto record_name() const -> std::string_view { return method_name(m_method); }
 	};
 
 	template <class Data, class Handler>
 	void data_source::subscription_base::emit_data(Data data, const Handler & handler)
 	{
+		QTOR_TRACE_SCOPE("subscription::emit_data");
+
 		auto owner = static_cast<data_source *>(m_owner);
 		auto * executor = owner->m_executor;
 		if (not executor)
 			handler(data);
 		else
 		{
-			auto action = [that = ext::intrusive_ptr<subscription_base>(this), data = std::move(data), &handler]() mutable
+			auto posted = tracing::enabled() ? tracing::now() : 0;
+			metrics::pipeline().gui_queue_depth.add(1);
+
+			auto action = [that = ext::intrusive_ptr<subscription_base>(this), data = std::move(data), &handler, posted]() mutable
 			{
+				metrics::pipeline().gui_queue_depth.add(-1);
+
+				// time spent in gui executor queue
+				if (posted) tracing::record("gui_executor::hop", posted, tracing::now());
+
+				QTOR_TRACE_SCOPE("subscription::handler");
 				handler(data);
 			};
 			
@@ -99,33 +205,42 @@ namespace transmission
 
 	void data_source::subscription_base::request(ext::net::socket_streambuf & streambuf)
 	{
-		std::ostream stream(&streambuf);
+		QTOR_TRACE_SCOPE("subscription::request");
 
 		auto owner = static_cast<data_source *>(m_owner);
-		auto & uri = owner->m_encoded_uri;
-		auto & session = owner->m_xtransmission_session;
+		auto generation = owner->m_request_generation.load(std::memory_order_relaxed);
 
-		auto body = request_command();
-		auto command = extract_command(body);
+		if (not m_body_valid)
+		{
+			m_body.clear();
+			request_command(m_body);
+			m_body_valid = true;
+			m_http_generation = 0;
+		}
 
-		EXTLL_DEBUG_FMT(logger(), "subscription {}: sending {} command", fmt::ptr(this), command);
+		if (m_http_generation != generation)
+		{
+			m_http.clear();
+			make_http_request(m_http, owner->m_encoded_uri, host(), owner->m_xtransmission_session, m_body);
+			m_http_generation = generation;
+		}
 
-		stream
-			<< "POST " << uri << " HTTP/1.1\r\n"
-			<< "Host: " << host() << "\r\n"
-			<< "Content-Length: " << body.size() << "\r\n"
-			<< "Accept-Encoding: deflate, gzip\r\n";
+		auto command = method_name(m_method);
+		auto & rpc_stats = method_metrics(m_method);
+		rpc_stats.requests.add();
+		rpc_stats.request_bytes.add(m_body.size());
 
-		if (not session.empty())
-			stream << "X-Transmission-Session-Id: " << session << "\r\n";
+		EXTLL_DEBUG_FMT(logger(), "subscription {}: sending {} command", fmt::ptr(this), command);
+		m_sent = std::chrono::steady_clock::now();
 
-		stream << "\r\n" << body;
+		streambuf.sputn(m_http.data(), m_http.size());
 
 		EXTLL_TRACE_FMT(logger(), "subscription {}: sent {} command", fmt::ptr(this), command);
 	}
 
 	void data_source::subscription_base::response(ext::net::socket_streambuf & streambuf)
 	{
+		QTOR_TRACE_SCOPE("subscription::response");
 		EXTLL_DEBUG_FMT(logger(), "subscription {}: receiving answer", fmt::ptr(this));
 
 		auto owner = static_cast<data_source *>(m_owner);
@@ -138,15 +253,33 @@ namespace transmission
 		int code = parser.http_code();
 		if (code / 100 == 2)
 		{
-			ext::net::parse_http_response(parser, streambuf, body);
-			m_next = std::chrono::steady_clock::now() + m_delay;
+			{
+				QTOR_TRACE_SCOPE("subscription::read_body");
+				ext::net::parse_http_response(parser, streambuf, body);
+			}
+
+			auto now = std::chrono::steady_clock::now();
+			owner->m_last_latency.store((now - m_sent).count(), std::memory_order_relaxed);
+			auto & rpc_stats = method_metrics(m_method);
+			rpc_stats.response_bytes.add(body.size());
+			rpc_stats.latency_us.record(std::chrono::duration_cast<std::chrono::microseconds>(now - m_sent).count());
+
+			if (auto recorder = std::atomic_load(&owner->m_recorder))
+				recorder->record(record_name(), body);
+
+			m_next = now + m_delay;
+
+			QTOR_TRACE_SCOPE("subscription::process_response");
 			process_response(std::move(body));
 		}
 		else if (code == 409)
 		{
 			while (parser.parse_header(streambuf, name, body))
 				if (name == "X-Transmission-Session-Id")
+				{
 					session = body;
+					owner->m_request_generation.fetch_add(1, std::memory_order_relaxed);
+				}
 
 			EXTLL_INFO_FMT(logger(), "subscription {}: got HTTP 409 code, Transmission-Session-Id - {}", fmt::ptr(this), session);
 
@@ -164,33 +297,33 @@ namespace transmission
 
 	void data_source::request_base::request(ext::net::socket_streambuf & streambuf)
 	{
-		std::ostream stream(&streambuf);
+		QTOR_TRACE_SCOPE("request::request");
 
 		auto owner = static_cast<data_source *>(m_owner);
-		auto & uri = owner->m_encoded_uri;
-		auto & session = owner->m_xtransmission_session;
 
-		auto body = request_command();
-		auto command = extract_command(body);
+		m_body.clear();
+		request_command(m_body);
 
-		EXTLL_DEBUG_FMT(logger(), "request {}: sending {} command", fmt::ptr(this), command);
+		// request can be repeated after 409, session id changes - so http request is always rebuilt
+		m_http.clear();
+		make_http_request(m_http, owner->m_encoded_uri, host(), owner->m_xtransmission_session, m_body);
 
-		stream
-			<< "POST " << uri << " HTTP/1.1\r\n"
-			<< "Host: " << host() << "\r\n"
-			<< "Content-Length: " << body.size() << "\r\n"
-			<< "Accept-Encoding: deflate, gzip\r\n";
+		auto command = method_name(m_method);
+		auto & rpc_stats = method_metrics(m_method);
+		rpc_stats.requests.add();
+		rpc_stats.request_bytes.add(m_body.size());
 
-		if (not session.empty())
-			stream << "X-Transmission-Session-Id: " << session << "\r\n";
+		EXTLL_DEBUG_FMT(logger(), "request {}: sending {} command", fmt::ptr(this), command);
+		m_sent = std::chrono::steady_clock::now();
 
-		stream << "\r\n" << body;
+		streambuf.sputn(m_http.data(), m_http.size());
 
 		EXTLL_TRACE_FMT(logger(), "request {}: sent {} command", fmt::ptr(this), command);
 	}
 
 	void data_source::request_base::response(ext::net::socket_streambuf & streambuf)
 	{
+		QTOR_TRACE_SCOPE("request::response");
 		EXTLL_DEBUG_FMT(logger(), "request {}: receiving answer", fmt::ptr(this));
 
 		auto owner = static_cast<data_source *>(m_owner);
@@ -204,13 +337,23 @@ namespace transmission
 		if (code / 100 == 2)
 		{
 			ext::net::parse_http_response(parser, streambuf, body);
+			auto now = std::chrono::steady_clock::now();
+			owner->m_last_latency.store((now - m_sent).count(), std::memory_order_relaxed);
+			auto & rpc_stats = method_metrics(m_method);
+			rpc_stats.response_bytes.add(body.size());
+			rpc_stats.latency_us.record(std::chrono::duration_cast<std::chrono::microseconds>(now - m_sent).count());
+
+			QTOR_TRACE_SCOPE("request::parse_response");
 			parse_response(std::move(body));
 		}
 		else if (code == 409)
 		{
 			while (parser.parse_header(streambuf, name, body))
 				if (name == "X-Transmission-Session-Id")
+				{
 					session = body;
+					owner->m_request_generation.fetch_add(1, std::memory_order_relaxed);
+				}
 
 			EXTLL_INFO_FMT(logger(), "subscription {}: get HTTP 409 code, Transmission-Session-Id - {}", fmt::ptr(this), session);
 
@@ -235,14 +378,14 @@ namespace transmission
 		torrent_id_list m_request_idx;
 
 	public:
-		auto request_command() -> std::string override
-		{ 
-			return make_torrent_get_command(m_request_idx);
+		void request_command(request_buffer & out) override
+		{
+			make_torrent_get_command(out, m_request_idx);
 		}
 
 		void parse_response(std::string body) override
 		{
-			auto tlist = parse_torrent_list(body);
+			auto tlist = parse_torrent_list(body, pool());
 			set_value(std::move(tlist));
 		}
 	};
@@ -255,15 +398,14 @@ namespace transmission
 		torrent_id_type m_request_id;
 
 	public:
-		auto request_command() -> std::string override
+		void request_command(request_buffer & out) override
 		{
-			auto cmd = make_torrent_files_get_command(m_request_id);
-			return cmd;
+			make_torrent_files_get_command(out, m_request_id);
 		}
 
 		void parse_response(std::string body) override
 		{
-			auto list = parse_torrent_file_list(body);
+			auto list = parse_torrent_file_list(body, pool());
 			set_value(std::move(list));
 		}
 	};
@@ -276,19 +418,117 @@ namespace transmission
 		torrent_id_type m_request_id;
 
 	public:
-		auto request_command() -> std::string override
+		void request_command(request_buffer & out) override
 		{
-			auto cmd = make_tracker_list_get_command(m_request_id);
-			return cmd;
+			make_tracker_list_get_command(out, m_request_id);
 		}
 
 		void parse_response(std::string body) override
 		{
-			auto list = parse_tracker_list(body);
+			auto list = parse_tracker_list(body, pool());
 			set_value(std::move(list));
 		}
 	};
 
+	class data_source::torrent_file_map_request : public request<torrent_file_map>
+	{
+		using base_type = data_source::request<torrent_file_map>;
+
+	public:
+		torrent_id_list m_request_idx;
+
+	public:
+		void request_command(request_buffer & out) override
+		{
+			make_torrent_files_batch_get_command(out, m_request_idx);
+		}
+
+		void parse_response(std::string body) override
+		{
+			auto map = parse_torrent_file_map(body, pool());
+			set_value(std::move(map));
+		}
+	};
+
+	class data_source::tracker_map_request : public request<tracker_map>
+	{
+		using base_type = data_source::request<tracker_map>;
+
+	public:
+		torrent_id_list m_request_idx;
+
+	public:
+		void request_command(request_buffer & out) override
+		{
+			make_tracker_list_batch_get_command(out, m_request_idx);
+		}
+
+		void parse_response(std::string body) override
+		{
+			auto map = parse_tracker_map(body, pool());
+			set_value(std::move(map));
+		}
+	};
+
+	class data_source::torrent_detail_request : public request<torrent_detail>
+	{
+		using base_type = data_source::request<torrent_detail>;
+
+	public:
+		torrent_id_type m_request_id;
+
+	public:
+		void request_command(request_buffer & out) override
+		{
+			make_torrent_detail_get_command(out, m_request_id);
+		}
+
+		void parse_response(std::string body) override
+		{
+			auto detail = parse_torrent_detail(body, pool());
+			set_value(std::move(detail));
+		}
+	};
+
+	class data_source::torrent_peer_list_request : public request<torrent_peer_list>
+	{
+		using base_type = data_source::request<torrent_peer_list>;
+
+	public:
+		torrent_id_type m_request_id;
+
+	public:
+		void request_command(request_buffer & out) override
+		{
+			make_torrent_peers_get_command(out, m_request_id);
+		}
+
+		void parse_response(std::string body) override
+		{
+			auto list = parse_torrent_peer_list(body, pool());
+			set_value(std::move(list));
+		}
+	};
+
+	class data_source::session_stat_request : public request<session_stat>
+	{
+		using base_type = data_source::request<session_stat>;
+
+	public:
+		session_stat_request() { m_method = rpc_method::session_stats; }
+
+		void request_command(request_buffer & out) override
+		{
+			make_session_stats_command(out);
+		}
+
+		void parse_response(std::string body) override
+		{
+			auto stat = parse_statistics(body);
+			set_value(std::move(stat));
+		}
+	};
+
 	class data_source::torrent_subscription : public subscription_base
 	{
 	public:
@@ -296,18 +536,300 @@ namespace transmission
 		torrent_handler m_handler;
 
 	public:
-		auto request_command() -> std::string override
+		void request_command(request_buffer & out) override
 		{
-			return make_torrent_get_command(m_request_idx);
+			make_torrent_get_command(out, m_request_idx);
 		}
 
 		void process_response(std::string body) override
 		{
-			auto tlist = parse_torrent_list(body);
+			auto start = tracing::now();
+			auto tlist = parse_torrent_list(body, pool());
+			// drop strings no longer referenced by stores, keeps pool gauges current
+			pool()->collect();
+			if (not tlist.empty())
+				metrics::pipeline().parse_ns_per_torrent.record((tracing::now() - start) / tlist.size());
+
 			emit_data(std::move(tlist), m_handler);
 		}
 	};
 
+	class data_source::torrent_detail_subscription : public subscription_base
+	{
+	public:
+		torrent_id_type m_request_id;
+		torrent_detail_handler m_handler;
+
+	public:
+		// detail view is interactive, poll it faster than torrent list
+		torrent_detail_subscription() { m_delay = std::chrono::seconds(1); }
+
+	public:
+		// torrent-get as torrent_subscription, but with different fields
+		auto record_name() const -> std::string_view override { return "torrent-get:detail"; }
+
+		void request_command(request_buffer & out) override
+		{
+			make_torrent_detail_get_command(out, m_request_id);
+		}
+
+		void process_response(std::string body) override
+		{
+			auto detail = parse_torrent_detail(body, pool());
+			emit_data(std::move(detail), m_handler);
+		}
+	};
+
+	class data_source::torrent_peer_subscription : public subscription_base
+	{
+	public:
+		torrent_id_type m_request_id;
+		torrent_peer_handler m_handler;
+
+	protected:
+		/// last received snapshot, keyed by peer_key
+		std::unordered_map<string_type, torrent_peer> m_peers;
+
+	protected:
+		auto diff_snapshot(torrent_peer_list & peers) -> torrent_peer_diff;
+
+	public:
+		torrent_peer_subscription() { m_delay = std::chrono::seconds(1); }
+
+	public:
+		auto record_name() const -> std::string_view override { return "torrent-get:peers"; }
+
+		void request_command(request_buffer & out) override
+		{
+			make_torrent_peers_get_command(out, m_request_id);
+		}
+
+		void process_response(std::string body) override
+		{
+			auto peers = parse_torrent_peer_list(body, pool());
+			auto diff = diff_snapshot(peers);
+
+			if (diff.added.empty() and diff.changed.empty() and diff.removed.empty())
+				return;
+
+			emit_data(std::move(diff), m_handler);
+		}
+	};
+
+	auto data_source::torrent_peer_subscription::diff_snapshot(torrent_peer_list & peers) -> torrent_peer_diff
+	{
+		torrent_peer_diff diff;
+		std::unordered_map<string_type, torrent_peer> current;
+		current.reserve(peers.size());
+
+		for (auto & peer : peers)
+		{
+			auto key = peer_key(peer);
+			auto it = m_peers.find(key);
+
+			if (it == m_peers.end())
+				diff.added.push_back(peer);
+			else
+			{
+				if (it->second != peer)
+					diff.changed.push_back(peer);
+
+				m_peers.erase(it);
+			}
+
+			current.emplace(std::move(key), std::move(peer));
+		}
+
+		// whatever left was not present in new snapshot
+		diff.removed.reserve(m_peers.size());
+		for (auto & [key, peer] : m_peers)
+			diff.removed.push_back(key);
+
+		m_peers = std::move(current);
+		return diff;
+	}
+
+	/// Requests files of a torrent once, after that polls only fileStats: paths and lengths do not change,
+	/// so they are neither resent by transmission, nor reparsed. Stats are emitted only if some file changed.
+	/// If file count changes(magnet link got metadata) - full file list is requested again.
+	class data_source::torrent_file_subscription : public subscription_base
+	{
+	public:
+		torrent_id_type m_request_id;
+		torrent_file_handler m_handler;
+
+	protected:
+		enum stage_type { files, stats };
+
+		stage_type m_stage = files;
+		/// last received stats, by file index
+		torrent_file_stat_list m_stats;
+
+	protected:
+		static bool same_stats(const torrent_file_stat_list & s1, const torrent_file_stat_list & s2) noexcept;
+
+	public:
+		torrent_file_subscription() { m_delay = std::chrono::seconds(1); }
+
+	public:
+		auto record_name() const -> std::string_view override
+		{
+			return m_stage == files ? "torrent-get:files" : "torrent-get:file-stats";
+		}
+
+		void request_command(request_buffer & out) override
+		{
+			if (m_stage == files)
+				make_torrent_files_get_command(out, m_request_id);
+			else
+				make_torrent_file_stats_get_command(out, m_request_id);
+		}
+
+		void process_response(std::string body) override
+		{
+			torrent_file_update update;
+
+			if (m_stage == files)
+			{
+				update.full = true;
+				update.files = parse_torrent_file_list(body, pool());
+
+				m_stats.clear();
+				m_stats.reserve(update.files.size());
+				for (auto & file : update.files)
+					m_stats.push_back({file.have_size, file.priority, file.wanted});
+
+				m_stage = stats;
+				invalidate_request();
+			}
+			else
+			{
+				update.stats = parse_torrent_file_stat_list(body);
+				if (update.stats.size() != m_stats.size())
+				{
+					// file list changed, fetch it anew right away
+					m_stage = files;
+					m_next = std::chrono::steady_clock::now();
+					invalidate_request();
+					return;
+				}
+
+				if (same_stats(update.stats, m_stats))
+					return;
+
+				m_stats = update.stats;
+			}
+
+			emit_data(std::move(update), m_handler);
+		}
+	};
+
+	bool data_source::torrent_file_subscription::same_stats(const torrent_file_stat_list & s1, const torrent_file_stat_list & s2) noexcept
+	{
+		auto equal = [](const torrent_file_stat & st1, const torrent_file_stat & st2)
+		{
+			return st1.have_size == st2.have_size and st1.priority == st2.priority and st1.wanted == st2.wanted;
+		};
+
+		return std::equal(s1.begin(), s1.end(), s2.begin(), s2.end(), equal);
+	}
+
+	/// Polls session-stats every tick, and free-space of download directory every ms_free_space_period tick.
+	/// Download directory is queried with session-get before first free-space request, and again if that failed.
+	/// Failed session-get or free-space only leave free space unknown, session-stats failures are reported as usual.
+	class data_source::session_stat_subscription : public subscription_base
+	{
+	public:
+		session_stat_handler m_handler;
+
+	protected:
+		enum stage_type { download_dir, stats, free_space };
+
+		static constexpr unsigned ms_free_space_period = 30;
+
+		stage_type m_stage = download_dir;
+		unsigned m_tick = 0;
+		session_stat m_stat;
+
+	public:
+		session_stat_subscription() { m_delay = std::chrono::seconds(1); m_method = rpc_method::session_get; }
+
+	public:
+		void request_command(request_buffer & out) override
+		{
+			switch (m_stage)
+			{
+				case download_dir:
+					m_method = rpc_method::session_get;
+					return make_download_dir_get_command(out);
+
+				case free_space:
+					m_method = rpc_method::free_space;
+					return make_free_space_command(out, m_stat.download_dir);
+
+				case stats:
+				default:
+					m_method = rpc_method::session_stats;
+					return make_session_stats_command(out);
+			}
+		}
+
+		void process_response(std::string body) override
+		{
+			auto now = std::chrono::steady_clock::now();
+
+			switch (m_stage)
+			{
+				case download_dir:
+				case free_space:
+					// auxiliary requests must not stall stats: failure is logged,
+					// stats are emitted without free space and download dir is requested again next free space period
+					try
+					{
+						if (m_stage == download_dir)
+						{
+							m_stat.download_dir = parse_download_dir(body);
+							// go straight to free space, stats will follow it
+							m_stage = free_space;
+						}
+						else
+						{
+							m_stat.free_space = parse_free_space(body);
+							m_stage = stats;
+						}
+					}
+					catch (std::exception & ex)
+					{
+						EXTLL_WARN_FMT(logger(), "subscription {}: {} failed: {}", fmt::ptr(this), method_name(m_method), ex.what());
+						m_stat.free_space = nullopt;
+						m_stage = stats;
+					}
+
+					m_next = now;
+					invalidate_request();
+					return;
+
+				case stats:
+				default:
+				{
+					auto stat = parse_statistics(body);
+					stat.download_dir = m_stat.download_dir;
+					stat.free_space = m_stat.free_space;
+					m_stat = stat;
+
+					if (++m_tick % ms_free_space_period == 0)
+					{
+						m_stage = m_stat.download_dir.isEmpty() ? download_dir : free_space;
+						invalidate_request();
+					}
+
+					emit_data(std::move(stat), m_handler);
+					return;
+				}
+			}
+		}
+	};
+
 
 	class data_source::torrent_action_request : public request<void>
 	{
@@ -315,12 +837,15 @@ namespace transmission
 
 	public:
 		torrent_id_list m_ids;
-		std::string m_action;
+		std::string m_arguments;
 
 	public:
-		auto request_command() -> std::string override
+		/// action is request method: torrent-start, torrent-stop, ...
+		torrent_action_request(rpc_method action) { m_method = action; }
+
+		void request_command(request_buffer & out) override
 		{
-			return make_request_command(m_action, m_ids);
+			make_action_command(out, m_method, m_ids, m_arguments);
 		}
 
 		void parse_response(std::string body) override
@@ -350,44 +875,153 @@ namespace transmission
 		return this->add_subscription(std::move(obj));
 	}
 
-	auto data_source::get_torrent_files(torrent_id_type idx) -> ext::future<torrent_file_list>
+	auto data_source::get_session_stats() -> ext::future<session_stat>
 	{
-		auto obj = ext::make_intrusive<torrent_file_list_request>();
-		obj->m_request_id = std::move(idx);
+		auto obj = ext::make_intrusive<session_stat_request>();
 		return this->add_request(std::move(obj));
 	}
 
+	auto data_source::subscribe_session_stats(session_stat_handler handler) -> ext::net::subscription_handle
+	{
+		auto obj = ext::make_intrusive<session_stat_subscription>();
+		obj->m_handler = std::move(handler);
+		return this->add_subscription(std::move(obj));
+	}
+
+	auto data_source::get_torrent_files(torrent_id_type idx) -> ext::future<torrent_file_list>
+	{
+		return m_files_cache.acquire(idx, [this, &idx]
+		{
+			auto obj = ext::make_intrusive<torrent_file_list_request>();
+			obj->m_request_id = idx;
+			return this->add_request(std::move(obj));
+		});
+	}
+
 	auto data_source::get_trackers(torrent_id_type idx) -> ext::future<tracker_list>
 	{
-		auto obj = ext::make_intrusive<tracker_list_request>();
+		return m_trackers_cache.acquire(idx, [this, &idx]
+		{
+			auto obj = ext::make_intrusive<tracker_list_request>();
+			obj->m_request_id = idx;
+			return this->add_request(std::move(obj));
+		});
+	}
+
+	auto data_source::get_torrent_files(torrent_id_list idx) -> ext::future<torrent_file_map>
+	{
+		// empty ids list means all torrents for torrent-get, which is not what caller wants here
+		if (idx.empty()) return ext::make_ready_future(torrent_file_map());
+
+		auto obj = ext::make_intrusive<torrent_file_map_request>();
+		obj->m_request_idx = std::move(idx);
+		return this->add_request(std::move(obj));
+	}
+
+	auto data_source::get_trackers(torrent_id_list idx) -> ext::future<tracker_map>
+	{
+		if (idx.empty()) return ext::make_ready_future(tracker_map());
+
+		auto obj = ext::make_intrusive<tracker_map_request>();
+		obj->m_request_idx = std::move(idx);
+		return this->add_request(std::move(obj));
+	}
+
+	auto data_source::get_torrent_detail(torrent_id_type idx) -> ext::future<torrent_detail>
+	{
+		auto obj = ext::make_intrusive<torrent_detail_request>();
 		obj->m_request_id = std::move(idx);
 		return this->add_request(std::move(obj));
 	}
 
-	auto data_source::start_torrents(torrent_id_list ids) -> ext::future<void>
+	auto data_source::subscribe_torrent_detail(torrent_id_type idx, torrent_detail_handler handler) -> ext::net::subscription_handle
 	{
-		auto obj = ext::make_intrusive<torrent_action_request>();
-		obj->m_ids = std::move(ids);
-		obj->m_action = torrent_start;
+		auto obj = ext::make_intrusive<torrent_detail_subscription>();
+		obj->m_request_id = std::move(idx);
+		obj->m_handler = std::move(handler);
+		return this->add_subscription(std::move(obj));
+	}
 
+	auto data_source::get_torrent_peers(torrent_id_type idx) -> ext::future<torrent_peer_list>
+	{
+		auto obj = ext::make_intrusive<torrent_peer_list_request>();
+		obj->m_request_id = std::move(idx);
 		return this->add_request(std::move(obj));
 	}
 
-	auto data_source::start_torrents_now(torrent_id_list ids) -> ext::future<void>
+	auto data_source::subscribe_torrent_peers(torrent_id_type idx, torrent_peer_handler handler) -> ext::net::subscription_handle
 	{
-		auto obj = ext::make_intrusive<torrent_action_request>();
+		auto obj = ext::make_intrusive<torrent_peer_subscription>();
+		obj->m_request_id = std::move(idx);
+		obj->m_handler = std::move(handler);
+		return this->add_subscription(std::move(obj));
+	}
+
+	auto data_source::subscribe_torrent_files(torrent_id_type idx, torrent_file_handler handler) -> ext::net::subscription_handle
+	{
+		auto obj = ext::make_intrusive<torrent_file_subscription>();
+		obj->m_request_id = std::move(idx);
+		obj->m_handler = std::move(handler);
+		return this->add_subscription(std::move(obj));
+	}
+
+	auto data_source::send_torrent_action(rpc_method method, torrent_id_list ids, std::string arguments /* = {} */) -> ext::future<void>
+	{
+		auto obj = ext::make_intrusive<torrent_action_request>(method);
 		obj->m_ids = std::move(ids);
-		obj->m_action = torrent_start_now;
+		obj->m_arguments = std::move(arguments);
 
-		return this->add_request(std::move(obj));
+		invalidate_cache();
+		return this->add_request(std::move(obj)).then([this](ext::future<void> result)
+		{
+			invalidate_cache();
+			return result.get();
+		});
+	}
+
+	auto data_source::start_torrents(torrent_id_list ids) -> ext::future<void>
+	{
+		return send_torrent_action(rpc_method::torrent_start, std::move(ids));
+	}
+
+	auto data_source::start_torrents_now(torrent_id_list ids) -> ext::future<void>
+	{
+		return send_torrent_action(rpc_method::torrent_start_now, std::move(ids));
 	}
 
 	auto data_source::stop_torrents(torrent_id_list ids) -> ext::future<void>
 	{
-		auto obj = ext::make_intrusive<torrent_action_request>();
-		obj->m_ids = std::move(ids);
-		obj->m_action = torrent_stop;
+		return send_torrent_action(rpc_method::torrent_stop, std::move(ids));
+	}
 
-		return this->add_request(std::move(obj));
+	auto data_source::verify_torrents(torrent_id_list ids) -> ext::future<void>
+	{
+		return send_torrent_action(rpc_method::torrent_verify, std::move(ids));
+	}
+
+	auto data_source::announce_torrents(torrent_id_list ids) -> ext::future<void>
+	{
+		return send_torrent_action(rpc_method::torrent_reannounce, std::move(ids));
+	}
+
+	auto data_source::set_torrent_location(torrent_id_type id, std::string newloc, bool move) -> ext::future<void>
+	{
+		return send_torrent_action(rpc_method::torrent_set_location, {id}, make_torrent_set_location_arguments(newloc, move));
+	}
+
+	auto data_source::remove_torrents(torrent_id_list ids) -> ext::future<void>
+	{
+		if (ids.empty())
+			return ext::make_exceptional_future<void>(std::make_exception_ptr(std::invalid_argument("data_source::remove_torrents: empty torrent ids list")));
+
+		return send_torrent_action(rpc_method::torrent_remove, std::move(ids), make_torrent_remove_arguments(false));
+	}
+
+	auto data_source::purge_torrents(torrent_id_list ids) -> ext::future<void>
+	{
+		if (ids.empty())
+			return ext::make_exceptional_future<void>(std::make_exception_ptr(std::invalid_argument("data_source::purge_torrents: empty torrent ids list")));
+
+		return send_torrent_action(rpc_method::torrent_remove, std::move(ids), make_torrent_remove_arguments(true));
 	}
 }}
@@ -0,0 +1,233 @@
+#include <qtor/transmission/replay_data_source.hpp>
+#include <qtor/transmission/requests.hpp>
+#include <qtor/metrics.hpp>
+#include <QtTools/gui_executor.hqt>
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace qtor {
+namespace transmission
+{
+	void replay_data_source::subscription::do_close_request(unique_lock lk)
+	{
+		notify_closed(std::move(lk));
+	}
+
+	void replay_data_source::subscription::do_pause_request(unique_lock lk)
+	{
+		notify_paused(std::move(lk));
+	}
+
+	void replay_data_source::subscription::do_resume_request(unique_lock lk)
+	{
+		notify_resumed(std::move(lk));
+	}
+
+	void replay_data_source::do_connect_request(unique_lock lk)
+	{
+		std::unique_ptr<response_reader> reader;
+
+		try
+		{
+			reader = std::make_unique<response_reader>(m_path);
+		}
+		catch (std::runtime_error & ex)
+		{
+			m_errmsg = ex.what();
+			notify_disconnected(std::move(lk));
+			return;
+		}
+
+		m_stopping = false;
+		m_pending = 0;
+		m_guard = std::make_shared<emit_guard>();
+		m_guard->owner = this;
+
+		m_thread = std::thread(&replay_data_source::play, this, std::move(reader));
+		notify_connected(std::move(lk));
+	}
+
+	void replay_data_source::do_disconnect_request(unique_lock lk)
+	{
+		stop_playing();
+		notify_disconnected(std::move(lk));
+	}
+
+	void replay_data_source::stop_playing()
+	{
+		{
+			std::lock_guard lk(m_data_mutex);
+			m_stopping = true;
+		}
+
+		m_data_cond.notify_all();
+		if (m_thread.joinable())
+			m_thread.join();
+
+		// waits for delivery in progress, if any, snapshots still queued are dropped
+		if (m_guard)
+		{
+			std::lock_guard lk(m_guard->mutex);
+			m_guard->owner = nullptr;
+		}
+	}
+
+	void replay_data_source::play(std::unique_ptr<response_reader> reader)
+	{
+		using namespace std::chrono;
+		recorded_response rec;
+
+		bool pass_start = true;
+		steady_clock::time_point start;
+		microseconds offset;
+
+		for (;;)
+		{
+			if (not reader->next(rec))
+			{
+				if (not m_loop) return;
+
+				reader->rewind();
+				pass_start = true;
+				if (not reader->next(rec)) return;
+			}
+
+			if (rec.method != torrent_get) continue;
+
+			if (pass_start)
+			{
+				start = steady_clock::now();
+				offset = rec.time;
+				pass_start = false;
+			}
+
+			{
+				std::unique_lock lk(m_data_mutex);
+				if (m_speed > 0)
+				{
+					auto due = start + duration_cast<steady_clock::duration>((rec.time - offset) / m_speed);
+					m_data_cond.wait_until(lk, due, [this] { return m_stopping; });
+				}
+				else
+				{
+					// do not flood gui thread, wait until previous snapshot is delivered
+					m_data_cond.wait(lk, [this] { return m_stopping or m_pending == 0; });
+				}
+
+				if (m_stopping) return;
+			}
+
+			torrent_list list;
+			try
+			{
+				list = parse_torrent_list(rec.body, &m_string_pool);
+				m_string_pool.collect();
+			}
+			catch (std::exception & ex)
+			{
+				std::lock_guard lk(m_data_mutex);
+				m_errmsg = ex.what();
+				continue;
+			}
+
+			emit_torrents(std::move(list));
+		}
+	}
+
+	void replay_data_source::emit_torrents(torrent_list list)
+	{
+		if (not m_executor)
+			return deliver(list);
+
+		{
+			std::lock_guard lk(m_data_mutex);
+			++m_pending;
+		}
+
+		m_executor->submit([guard = m_guard, list = std::move(list)]() mutable
+		{
+			std::lock_guard guard_lk(guard->mutex);
+			auto * owner = guard->owner;
+			if (not owner) return;
+
+			owner->deliver(list);
+
+			{
+				std::lock_guard lk(owner->m_data_mutex);
+				--owner->m_pending;
+			}
+
+			owner->m_data_cond.notify_all();
+		});
+	}
+
+	void replay_data_source::deliver(torrent_list & list)
+	{
+		std::vector<subscription_ptr> subs;
+
+		{
+			std::lock_guard lk(m_data_mutex);
+			m_torrents = list;
+			subs = m_subs;
+		}
+
+		for (auto & sub : subs)
+		{
+			if (sub->get_state() == sub->opened)
+				sub->m_handler(list);
+			else
+				metrics::pipeline().snapshots_dropped.add();
+		}
+
+		m_played.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	auto replay_data_source::subscribe_torrents(torrent_handler handler) -> ext::net::subscription_handle
+	{
+		auto sub = ext::make_intrusive<subscription>();
+		sub->m_handler = std::move(handler);
+
+		std::lock_guard lk(m_data_mutex);
+		m_subs.push_back(sub);
+		return {sub};
+	}
+
+	auto replay_data_source::get_torrents() -> ext::future<torrent_list>
+	{
+		std::lock_guard lk(m_data_mutex);
+		return ext::make_ready_future(m_torrents);
+	}
+
+	auto replay_data_source::get_torrents(torrent_id_list ids) -> ext::future<torrent_list>
+	{
+		if (ids.empty()) return get_torrents();
+
+		std::unordered_set<torrent_id_type> requested(ids.begin(), ids.end());
+		torrent_list result;
+
+		std::lock_guard lk(m_data_mutex);
+		std::copy_if(m_torrents.begin(), m_torrents.end(), std::back_inserter(result),
+			[&requested](auto & torr) { return requested.count(torr.id()); });
+
+		return ext::make_ready_future(std::move(result));
+	}
+
+	auto replay_data_source::get_torrent_detail(torrent_id_type id) -> ext::future<torrent_detail>
+	{
+		torrent_detail detail;
+		detail.id = std::move(id);
+		return ext::make_ready_future(std::move(detail));
+	}
+
+	std::string replay_data_source::last_errormsg() const
+	{
+		std::lock_guard lk(m_data_mutex);
+		return m_errmsg;
+	}
+
+	replay_data_source::~replay_data_source()
+	{
+		stop_playing();
+	}
+}}
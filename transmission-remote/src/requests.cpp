@@ -1,4 +1,5 @@
 ﻿#include <qtor/transmission/requests.hpp>
+#include <qtor/string_pool.hpp>
 #include <ext/range/combine.hpp>
 
 #include <fmt/format.h>
@@ -17,11 +18,6 @@ namespace transmission
 {
 	inline namespace constants
 	{
-		const std::string request_template = R"({{ "method": "{}", "arguments": {{ "fields": [ {} ], "ids": [ {} ] }} }})";
-		const std::string request_template_all = R"({{ "method": "{}", "arguments": {{ "fields": [ {} ] }} }})";
-		const std::string command_template = R"({{ "method": "{}", "arguments": {{ "ids": [ {} ] }} }})";
-		const std::string command_template_all = R"({{ "method": "{}" }})";
-
 		// commands
 		const std::string torrent_get = "torrent-get";
 		const std::string torrent_set = "torrent-set";
@@ -37,6 +33,10 @@ namespace transmission
 		const std::string torrent_purege = "torrent-purge";
 		const std::string torrent_set_location = "torrent-set-location";
 
+		const std::string session_get = "session-get";
+		const std::string session_stats = "session-stats";
+		const std::string free_space = "free-space";
+
 
 		// fields helpers
 		static const std::string Arguments = "arguments";
@@ -158,7 +158,7 @@ namespace transmission
 
 		const std::vector<std::string> request_default_fields =
 		{
-			Id, Name, Comment, Creator,
+			Id, HashString, Name, Comment, Creator,
 			Status, Error, ErrorString, IsFinished, IsStalled,
 			LeftUntilDone, SizeWhenDone, TotalSize,
 			DownloadedEver, UploadedEver, CorruptEver,
@@ -174,9 +174,14 @@ namespace transmission
 			Files, FileStats,
 		};
 
+		const std::vector<std::string> request_torrent_file_stats_fields =
+		{
+			FileStats,
+		};
+
 		const std::vector<std::string> request_torrent_peers_fields =
 		{
-			Trackers, TrackerStats,
+			Peers,
 		};
 
 		const std::vector<std::string> request_trackers_fields =
@@ -184,20 +189,71 @@ namespace transmission
 		    Trackers, TrackerStats,
 		};
 
-		std::regex method_regex(R"a("method":\s*"(.*?)")a", std::regex_constants::ECMAScript);
+		const std::vector<std::string> request_torrent_files_batch_fields =
+		{
+			Id, Files, FileStats,
+		};
+
+		const std::vector<std::string> request_trackers_batch_fields =
+		{
+			Id, Trackers, TrackerStats,
+		};
+
+		const std::vector<std::string> request_torrent_detail_fields =
+		{
+			Id, Files, FileStats, Trackers, TrackerStats, Peers,
+		};
+	}
+
+	auto method_name(rpc_method method) noexcept -> std::string_view
+	{
+		switch (method)
+		{
+			case rpc_method::torrent_get:          return torrent_get;
+			case rpc_method::torrent_set:          return torrent_set;
+			case rpc_method::torrent_add:          return torrent_add;
+			case rpc_method::torrent_start:        return torrent_start;
+			case rpc_method::torrent_start_now:    return torrent_start_now;
+			case rpc_method::torrent_stop:         return torrent_stop;
+			case rpc_method::torrent_verify:       return torrent_verify;
+			case rpc_method::torrent_reannounce:   return torrent_reannounce;
+			case rpc_method::torrent_remove:       return torrent_remove;
+			case rpc_method::torrent_set_location: return torrent_set_location;
+			case rpc_method::session_get:          return session_get;
+			case rpc_method::session_stats:        return session_stats;
+			case rpc_method::free_space:           return free_space;
+
+			default: return "<unknown>";
+		}
+	}
+
+	void make_download_dir_get_command(request_buffer & out)
+	{
+		static const std::string fields[] = {"download-dir"};
+		make_request_command(out, rpc_method::session_get, std::initializer_list<torrent_id_type>(), fields);
+	}
+
+	void make_free_space_command(request_buffer & out, const string_type & path)
+	{
+		auto paths = {QtTools::FromQString(path)};
+
+		append(out, R"({ "method": ")");
+		append(out, method_name(rpc_method::free_space));
+		append(out, R"(", "arguments": { "path": )");
+		write_json_strings(out, paths);
+		append(out, " } }");
 	}
 
-	std::string_view extract_command(std::string_view command)
+	auto make_torrent_set_location_arguments(const std::string & location, bool move) -> std::string
 	{
-		std::cmatch match_result;
-		auto first = command.data();
-		auto last  = first + command.size();
-		if (not std::regex_search(first, last, match_result, method_regex))
-			return "<not found>";
+		request_buffer out;
+		auto locations = {location};
 
-		first = match_result[1].first;
-		last  = match_result[1].second;
-		return std::string_view(first, last - first);
+		append(out, R"("location": )");
+		write_json_strings(out, locations);
+		append(out, move ? R"(, "move": true)" : R"(, "move": false)");
+
+		return fmt::to_string(out);
 	}
 
 	inline static bool valid(QJsonValue node)
@@ -213,6 +269,23 @@ namespace transmission
 		(t.*pmf)(data.toString());
 	}
 
+	/// for strings repeating across torrents, equal values share one buffer
+	static void parse_interned_string(const QJsonValue & node, torrent & t, torrent & (torrent::*pmf)(string_type val), string_pool * pool)
+	{
+		if (not valid(node)) return;
+		auto data = node.toVariant();
+		(t.*pmf)(intern(pool, data.toString()));
+	}
+
+	static void parse_int64(const QJsonValue & node, torrent & t, torrent & (torrent::*pmf)(int64_type val))
+	{
+		if (not valid(node)) return;
+
+		auto data = node.toVariant();
+		if (data.isValid() and data.canConvert<long long>())
+			(t.*pmf)(data.toLongLong());
+	}
+
 	static void parse_uint64(const QJsonValue & node, torrent & t, torrent & (torrent::*pmf)(uint64_type val))
 	{		
 		if (not valid(node)) return;
@@ -323,7 +396,7 @@ namespace transmission
 	}
 
 	
-	static torrent_list parse_torrent_list(const QJsonDocument & doc)
+	static torrent_list parse_torrent_list(const QJsonDocument & doc, string_pool * pool)
 	{
 		using QtTools::Json::get_path;
 		using QtTools::Json::find_path;
@@ -340,11 +413,12 @@ namespace transmission
 			#define READ(type, name, where) parse_##type(find_path(tnode, name), torr, &torrent::where)
 
 			parse_status(find_path(tnode, Status), torr);
-			READ(string, Id, id);
+			READ(int64, Id, id);
+			READ(string, HashString, hash_string);
 			READ(string, Name, name);
-			READ(string, Comment, comment);
-			READ(string, Creator, creator);			
-			READ(string, ErrorString, error_string);
+			parse_interned_string(find_path(tnode, Comment), torr, &torrent::comment, pool);
+			parse_interned_string(find_path(tnode, Creator), torr, &torrent::creator, pool);
+			parse_interned_string(find_path(tnode, ErrorString), torr, &torrent::error_string, pool);
 
 			READ(size, LeftUntilDone, left_size);
 			READ(size, SizeWhenDone, requested_size);
@@ -388,15 +462,14 @@ namespace transmission
 		return result;
 	}
 
-	static torrent_file_list parse_torrent_file_list(const QJsonDocument & doc)
+	static torrent_file_list parse_torrent_files(const QJsonValue & tnode, string_pool * pool)
 	{
-		using QtTools::Json::get_path;
+		using QtTools::Json::find_path;
 		torrent_file_list result;
 
-		check_success(doc);
-
-		auto files     = get_path(doc, "arguments/torrents/0/files").toArray();
-		auto fileStats = get_path(doc, "arguments/torrents/0/fileStats").toArray();
+		auto files     = find_path(tnode, Files).toArray();
+		auto fileStats = find_path(tnode, FileStats).toArray();
+		int_type index = 0;
 
 		for (auto [file_node_ref, file_stat_node_ref] : ext::combine(files, fileStats))
 		{
@@ -404,11 +477,13 @@ namespace transmission
 			QJsonValue file_stat_node = file_stat_node_ref;
 			torrent_file file;
 
-			file.filename = file_node["name"].toString();
+			// files are listed again on every detail and files refresh, pooled path is shared with stored file
+			file.filename = intern(pool, file_node["name"].toString());
 			file.total_size = file_node["length"].toDouble();
 			file.have_size = file_node["bytesCompleted"].toDouble();
 			file.wanted = file_stat_node["wanted"].toBool();
 			file.priority = file_stat_node["priority"].toInt();
+			file.index = index++;
 
 			result.push_back(std::move(file));
 		}
@@ -416,20 +491,40 @@ namespace transmission
 		return result;
 	}
 
-	static tracker_list parse_tracker_list(const QJsonDocument & doc)
+	static torrent_file_stat_list parse_torrent_file_stats(const QJsonValue & tnode)
 	{
-		using QtTools::Json::get_path;
-		tracker_list result;
+		using QtTools::Json::find_path;
+		torrent_file_stat_list result;
 
-		check_success(doc);
+		// entries go in files order, position is file index
+		auto fileStats = find_path(tnode, FileStats).toArray();
+		result.reserve(fileStats.size());
+
+		for (QJsonValue file_stat_node : fileStats)
+		{
+			torrent_file_stat stat;
+			stat.have_size = file_stat_node["bytesCompleted"].toDouble();
+			stat.wanted = file_stat_node["wanted"].toBool();
+			stat.priority = file_stat_node["priority"].toInt();
 
-		auto trackerStats = get_path(doc, "arguments/torrents/0/trackerStats").toArray();
+			result.push_back(stat);
+		}
+
+		return result;
+	}
+
+	static tracker_list parse_trackers(const QJsonValue & tnode, string_pool * pool)
+	{
+		using QtTools::Json::find_path;
+		tracker_list result;
+
+		auto trackerStats = find_path(tnode, TrackerStats).toArray();
 		for (QJsonValue trackerNode : trackerStats)
 		{
 			tracker_stat stat;
-			stat.host     = trackerNode["host"].toString();
-			stat.announce = trackerNode["announce"].toString();
-			stat.scrape   = trackerNode["scrape"].toString();
+			stat.host     = intern(pool, trackerNode["host"].toString());
+			stat.announce = intern(pool, trackerNode["announce"].toString());
+			stat.scrape   = intern(pool, trackerNode["scrape"].toString());
 
 			result.push_back(std::move(stat));
 		}
@@ -437,6 +532,143 @@ namespace transmission
 		return result;
 	}
 
+	static torrent_peer_list parse_peers(const QJsonValue & tnode, string_pool * pool)
+	{
+		using QtTools::Json::find_path;
+		torrent_peer_list result;
+
+		auto peers = find_path(tnode, Peers).toArray();
+		result.reserve(peers.size());
+
+		for (QJsonValue peerNode : peers)
+		{
+			torrent_peer peer;
+			peer.address           = peerNode["address"].toString();
+			peer.port              = peerNode["port"].toInt();
+			peer.client_name       = intern(pool, peerNode["clientName"].toString());
+			peer.flag_str          = peerNode["flagStr"].toString();
+			peer.client_choked     = peerNode["clientIsChoked"].toBool();
+			peer.client_interested = peerNode["clientIsInterested"].toBool();
+			peer.peer_choked       = peerNode["peerIsChoked"].toBool();
+			peer.peer_interested   = peerNode["peerIsInterested"].toBool();
+			peer.downloading_from  = peerNode["isDownloadingFrom"].toBool();
+			peer.uploading_to      = peerNode["isUploadingTo"].toBool();
+			peer.encrypted         = peerNode["isEncrypted"].toBool();
+			peer.incoming          = peerNode["isIncoming"].toBool();
+			peer.rate_to_client    = peerNode["rateToClient"].toDouble();
+			peer.rate_to_peer      = peerNode["rateToPeer"].toDouble();
+			peer.progress          = peerNode["progress"].toDouble();
+
+			result.push_back(std::move(peer));
+		}
+
+		return result;
+	}
+
+	static torrent_peer_list parse_torrent_peer_list(const QJsonDocument & doc, string_pool * pool)
+	{
+		using QtTools::Json::get_path;
+		check_success(doc);
+
+		return parse_peers(get_path(doc, "arguments/torrents/0"), pool);
+	}
+
+	static torrent_detail parse_torrent_detail(const QJsonDocument & doc, string_pool * pool)
+	{
+		using QtTools::Json::get_path;
+		using QtTools::Json::find_path;
+		check_success(doc);
+
+		auto tnode = get_path(doc, "arguments/torrents/0");
+
+		torrent_detail result;
+		result.id       = find_path(tnode, Id).toVariant().toLongLong();
+		result.files    = parse_torrent_files(tnode, pool);
+		result.trackers = parse_trackers(tnode, pool);
+		result.peers    = parse_peers(tnode, pool);
+
+		return result;
+	}
+
+	static torrent_file_list parse_torrent_file_list(const QJsonDocument & doc, string_pool * pool)
+	{
+		using QtTools::Json::get_path;
+		check_success(doc);
+
+		return parse_torrent_files(get_path(doc, "arguments/torrents/0"), pool);
+	}
+
+	static torrent_file_stat_list parse_torrent_file_stat_list(const QJsonDocument & doc)
+	{
+		using QtTools::Json::get_path;
+		check_success(doc);
+
+		return parse_torrent_file_stats(get_path(doc, "arguments/torrents/0"));
+	}
+
+	static tracker_list parse_tracker_list(const QJsonDocument & doc, string_pool * pool)
+	{
+		using QtTools::Json::get_path;
+		check_success(doc);
+
+		return parse_trackers(get_path(doc, "arguments/torrents/0"), pool);
+	}
+
+	template <class Map, class Parser>
+	static Map parse_torrent_map(const QJsonDocument & doc, Parser parser, string_pool * pool)
+	{
+		using QtTools::Json::get_path;
+		using QtTools::Json::find_path;
+		Map result;
+
+		check_success(doc);
+
+		auto torrents = get_path(doc, "arguments/torrents").toArray();
+		for (const QJsonValue & tnode : torrents)
+		{
+			torrent_id_type id = find_path(tnode, Id).toVariant().toLongLong();
+			result.insert_or_assign(std::move(id), parser(tnode, pool));
+		}
+
+		return result;
+	}
+
+	static session_stat parse_statistics(const QJsonDocument & doc)
+	{
+		using QtTools::Json::get_path;
+		check_success(doc);
+
+		auto args = get_path(doc, "arguments");
+		auto current = args["current-stats"];
+
+		session_stat stat;
+		stat.download_speed       = args["downloadSpeed"].toVariant().toULongLong();
+		stat.upload_speed         = args["uploadSpeed"].toVariant().toULongLong();
+		stat.torrent_count        = args["torrentCount"].toVariant().toULongLong();
+		stat.active_torrent_count = args["activeTorrentCount"].toVariant().toULongLong();
+		stat.paused_torrent_count = args["pausedTorrentCount"].toVariant().toULongLong();
+		stat.downloaded_bytes     = current["downloadedBytes"].toVariant().toULongLong();
+		stat.uploaded_bytes       = current["uploadedBytes"].toVariant().toULongLong();
+
+		return stat;
+	}
+
+	static string_type parse_download_dir(const QJsonDocument & doc)
+	{
+		using QtTools::Json::get_path;
+		check_success(doc);
+
+		return get_path(doc, "arguments/download-dir").toString();
+	}
+
+	static size_type parse_free_space(const QJsonDocument & doc)
+	{
+		using QtTools::Json::get_path;
+		check_success(doc);
+
+		return get_path(doc, "arguments/size-bytes").toVariant().toULongLong();
+	}
+
 	static void parse_command_response(const QJsonDocument & doc)
 	{
 		check_success(doc);
@@ -455,40 +687,136 @@ namespace transmission
 		return parse_command_response(jdoc);
 	}
 
-	torrent_file_list parse_torrent_file_list(const std::string & json)
+	session_stat parse_statistics(const std::string & json)
 	{
 		auto jdoc = QtTools::Json::parse_json(json);
-		return parse_torrent_file_list(jdoc);
+		return parse_statistics(jdoc);
 	}
 
-	torrent_file_list parse_torrent_file_list(std::istream & json_source)
+	session_stat parse_statistics(std::istream & json_stream)
+	{
+		auto jdoc = QtTools::Json::parse_json(json_stream);
+		return parse_statistics(jdoc);
+	}
+
+	string_type parse_download_dir(const std::string & json)
+	{
+		auto jdoc = QtTools::Json::parse_json(json);
+		return parse_download_dir(jdoc);
+	}
+
+	string_type parse_download_dir(std::istream & json_stream)
+	{
+		auto jdoc = QtTools::Json::parse_json(json_stream);
+		return parse_download_dir(jdoc);
+	}
+
+	size_type parse_free_space(const std::string & json)
+	{
+		auto jdoc = QtTools::Json::parse_json(json);
+		return parse_free_space(jdoc);
+	}
+
+	size_type parse_free_space(std::istream & json_stream)
+	{
+		auto jdoc = QtTools::Json::parse_json(json_stream);
+		return parse_free_space(jdoc);
+	}
+
+	torrent_file_list parse_torrent_file_list(const std::string & json, string_pool * pool /* = nullptr */)
+	{
+		auto jdoc = QtTools::Json::parse_json(json);
+		return parse_torrent_file_list(jdoc, pool);
+	}
+
+	torrent_file_list parse_torrent_file_list(std::istream & json_source, string_pool * pool /* = nullptr */)
 	{
 		auto jdoc = QtTools::Json::parse_json(json_source);
-		return parse_torrent_file_list(jdoc);
+		return parse_torrent_file_list(jdoc, pool);
 	}
 
-	torrent_list parse_torrent_list(const std::string & json)
+	torrent_file_stat_list parse_torrent_file_stat_list(const std::string & json)
 	{
 		auto jdoc = QtTools::Json::parse_json(json);
-		return parse_torrent_list(jdoc);
+		return parse_torrent_file_stat_list(jdoc);
+	}
+
+	torrent_file_stat_list parse_torrent_file_stat_list(std::istream & json_source)
+	{
+		auto jdoc = QtTools::Json::parse_json(json_source);
+		return parse_torrent_file_stat_list(jdoc);
 	}
 
-	torrent_list parse_torrent_list(std::istream & json_stream)
+	torrent_list parse_torrent_list(const std::string & json, string_pool * pool /* = nullptr */)
+	{
+		auto jdoc = QtTools::Json::parse_json(json);
+		return parse_torrent_list(jdoc, pool);
+	}
+
+	torrent_list parse_torrent_list(std::istream & json_stream, string_pool * pool /* = nullptr */)
 	{
 		auto jdoc = QtTools::Json::parse_json(json_stream);
-		return parse_torrent_list(jdoc);
+		return parse_torrent_list(jdoc, pool);
 	}
 
-	tracker_list parse_tracker_list(const std::string & json)
+	tracker_list parse_tracker_list(const std::string & json, string_pool * pool /* = nullptr */)
 	{
 		qDebug() << QtTools::ToQString(json);
 		auto jdoc = QtTools::Json::parse_json(json);
-		return parse_tracker_list(jdoc);
+		return parse_tracker_list(jdoc, pool);
+	}
+
+	tracker_list parse_tracker_list(std::istream & json_stream, string_pool * pool /* = nullptr */)
+	{
+		auto jdoc = QtTools::Json::parse_json(json_stream);
+		return parse_tracker_list(jdoc, pool);
+	}
+
+	torrent_peer_list parse_torrent_peer_list(const std::string & json, string_pool * pool /* = nullptr */)
+	{
+		auto jdoc = QtTools::Json::parse_json(json);
+		return parse_torrent_peer_list(jdoc, pool);
+	}
+
+	torrent_peer_list parse_torrent_peer_list(std::istream & json_stream, string_pool * pool /* = nullptr */)
+	{
+		auto jdoc = QtTools::Json::parse_json(json_stream);
+		return parse_torrent_peer_list(jdoc, pool);
+	}
+
+	torrent_detail parse_torrent_detail(const std::string & json, string_pool * pool /* = nullptr */)
+	{
+		auto jdoc = QtTools::Json::parse_json(json);
+		return parse_torrent_detail(jdoc, pool);
+	}
+
+	torrent_detail parse_torrent_detail(std::istream & json_stream, string_pool * pool /* = nullptr */)
+	{
+		auto jdoc = QtTools::Json::parse_json(json_stream);
+		return parse_torrent_detail(jdoc, pool);
+	}
+
+	torrent_file_map parse_torrent_file_map(const std::string & json, string_pool * pool /* = nullptr */)
+	{
+		auto jdoc = QtTools::Json::parse_json(json);
+		return parse_torrent_map<torrent_file_map>(jdoc, parse_torrent_files, pool);
+	}
+
+	torrent_file_map parse_torrent_file_map(std::istream & json_stream, string_pool * pool /* = nullptr */)
+	{
+		auto jdoc = QtTools::Json::parse_json(json_stream);
+		return parse_torrent_map<torrent_file_map>(jdoc, parse_torrent_files, pool);
+	}
+
+	tracker_map parse_tracker_map(const std::string & json, string_pool * pool /* = nullptr */)
+	{
+		auto jdoc = QtTools::Json::parse_json(json);
+		return parse_torrent_map<tracker_map>(jdoc, parse_trackers, pool);
 	}
 
-	tracker_list parse_tracker_list(std::istream & json_stream)
+	tracker_map parse_tracker_map(std::istream & json_stream, string_pool * pool /* = nullptr */)
 	{
 		auto jdoc = QtTools::Json::parse_json(json_stream);
-		return parse_tracker_list(jdoc);
+		return parse_torrent_map<tracker_map>(jdoc, parse_trackers, pool);
 	}
 }}
@@ -0,0 +1,103 @@
+#include <qtor/transmission/response_recorder.hpp>
+#include <stdexcept>
+#include <algorithm>
+#include <fmt/format.h>
+
+namespace qtor {
+namespace transmission
+{
+	static constexpr char recording_magic[8] = {'Q', 'T', 'O', 'R', 'R', 'E', 'C', '\1'};
+
+	template <class Integer>
+	static void write_integer(std::ostream & os, Integer val)
+	{
+		char buffer[sizeof(Integer)];
+		for (unsigned i = 0; i < sizeof(Integer); ++i)
+			buffer[i] = static_cast<char>(val >> (i * 8) & 0xFF);
+
+		os.write(buffer, sizeof(buffer));
+	}
+
+	template <class Integer>
+	static bool read_integer(std::istream & is, Integer & val)
+	{
+		unsigned char buffer[sizeof(Integer)];
+		if (not is.read(reinterpret_cast<char *>(buffer), sizeof(buffer)))
+			return false;
+
+		val = 0;
+		for (unsigned i = 0; i < sizeof(Integer); ++i)
+			val |= static_cast<Integer>(buffer[i]) << (i * 8);
+
+		return true;
+	}
+
+	void response_recorder::record(std::string_view method, std::string_view body)
+	{
+		using namespace std::chrono;
+		auto time = duration_cast<microseconds>(steady_clock::now() - m_start).count();
+		method = method.substr(0, 255);
+
+		std::lock_guard lk(m_mutex);
+		write_integer<std::uint64_t>(m_stream, time);
+		write_integer<std::uint8_t>(m_stream, static_cast<std::uint8_t>(method.size()));
+		m_stream.write(method.data(), method.size());
+		write_integer<std::uint32_t>(m_stream, static_cast<std::uint32_t>(body.size()));
+		m_stream.write(body.data(), body.size());
+	}
+
+	void response_recorder::flush()
+	{
+		std::lock_guard lk(m_mutex);
+		m_stream.flush();
+	}
+
+	response_recorder::response_recorder(const std::string & path)
+		: m_stream(path, std::ios::binary | std::ios::trunc), m_start(std::chrono::steady_clock::now())
+	{
+		if (not m_stream)
+			throw std::runtime_error(fmt::format("response_recorder: failed to open {}", path));
+
+		m_stream.write(recording_magic, sizeof(recording_magic));
+	}
+
+	response_recorder::~response_recorder()
+	{
+		m_stream.flush();
+	}
+
+	bool response_reader::next(recorded_response & rec)
+	{
+		std::uint64_t time;
+		std::uint8_t method_size;
+		std::uint32_t body_size;
+
+		if (not read_integer(m_stream, time)) return false;
+		if (not read_integer(m_stream, method_size)) return false;
+
+		rec.time = std::chrono::microseconds(time);
+		rec.method.resize(method_size);
+		if (not m_stream.read(rec.method.data(), method_size)) return false;
+
+		if (not read_integer(m_stream, body_size)) return false;
+		rec.body.resize(body_size);
+		return static_cast<bool>(m_stream.read(rec.body.data(), body_size));
+	}
+
+	void response_reader::rewind()
+	{
+		m_stream.clear();
+		m_stream.seekg(sizeof(recording_magic));
+	}
+
+	response_reader::response_reader(const std::string & path)
+		: m_stream(path, std::ios::binary)
+	{
+		if (not m_stream)
+			throw std::runtime_error(fmt::format("response_reader: failed to open {}", path));
+
+		char magic[sizeof(recording_magic)];
+		if (not m_stream.read(magic, sizeof(magic)) or not std::equal(magic, magic + sizeof(magic), recording_magic))
+			throw std::runtime_error(fmt::format("response_reader: {} is not a qtor recording", path));
+	}
+}}
@@ -1,5 +1,6 @@
 ﻿#include <csignal>
 #include <iostream>
+#include <deque>
 
 #include <sqlite3yaw.hpp>
 #include <sqlite3yaw_ext.hpp>
@@ -27,6 +28,7 @@ ext::library_logger::stream_logger g_logger {std::clog};
 qtor::transmission::data_source g_source;
 sqlite3yaw::session g_session;
 constexpr unsigned request_slots = 8;
+constexpr unsigned batch_size = 256;
 
 
 void print_help(const boost::program_options::options_description & opts)
@@ -44,47 +46,45 @@ void print_help(const boost::program_options::options_description & opts)
 
 template <class LoadFunc, class SaveFunc>
 void load_and_save(const qtor::torrent_list & torrents, LoadFunc loader, SaveFunc saver)
-{	
-	using future_type = std::invoke_result_t<LoadFunc, qtor::abstract_data_source &, qtor::torrent_id_type>;
-	std::array<future_type, request_slots> request_array;
+{
+	// loader requests details of whole batch of torrents in one request,
+	// up to request_slots such batched requests are kept in flight
+	using future_type = std::invoke_result_t<LoadFunc, qtor::abstract_data_source &, qtor::torrent_id_list>;
+	std::deque<future_type> requests;
+
+	auto first = torrents.begin();
+	auto last  = torrents.end();
 
-	const auto batch_count = torrents.size() / request_slots;
-	const auto left_count  = torrents.size() % request_slots;
-	const auto count = batch_count ? request_slots : left_count;
+	auto schedule = [&]
+	{
+		qtor::torrent_id_list ids;
+		for (unsigned i = 0; i < batch_size and first != last; ++i, ++first)
+			ids.push_back(first->id());
+
+		requests.push_back(loader(g_source, std::move(ids)));
+	};
 
 	// schedule enough torrents loads
-	for (unsigned i = 0; i < count; ++i)
-		request_array[i] = loader(g_source, torrents[i].id());
+	for (unsigned i = 0; i < request_slots and first != last; ++i)
+		schedule();
 
 	// process loaded ones and schedule new get operations
-	for (unsigned iteration = 0; iteration < batch_count; ++iteration)
+	while (not requests.empty())
 	{
-		for (unsigned i = 0; i < request_slots; ++i)
-		{
-			auto cur_idx = iteration * request_slots + i;
-			auto next_idx = iteration * request_slots + request_slots + i;
-			auto entity = request_array[i].get();
+		auto entities = requests.front().get();
+		requests.pop_front();
 
-			if (next_idx < torrents.size())
-				request_array[i] = loader(g_source, torrents[next_idx].id());
+		if (first != last)
+			schedule();
 
-			saver(g_session, std::move(entity), torrents[cur_idx].id());
-		}
-	}
-
-	// process leftovers
-	for (unsigned i = 0; i < left_count; ++i)
-	{
-		auto & save_tor = torrents[torrents.size() - left_count + i];
-		auto entity = request_array[i].get();
-		saver(g_session, std::move(entity), save_tor.id());
+		for (auto & [id, entity] : entities)
+			saver(g_session, entity, id);
 	}
 }
 
 void load_and_save_torrent_files(const qtor::torrent_list & torrents)
 {
-	using std::placeholders::_1; using std::placeholders::_2;
-	auto loader = std::bind(&qtor::abstract_data_source::get_torrent_files, _1, _2);
+	auto loader = [](qtor::abstract_data_source & source, qtor::torrent_id_list ids) { return source.get_torrent_files(std::move(ids)); };
 	auto saver = qtor::sqlite::save_torrent_files;
 	return load_and_save(torrents, loader, saver);
 }